@@ -0,0 +1,62 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include <iostream>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/variant.h"
+#include "gutil/status.h"
+#include "ipv4_router.p4info.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace p4runtime_cpp_example {
+
+namespace p4info = ::ipv4_router::p4info;
+
+absl::Status Main() {
+  // Route 10.0.0.0/8 in VRF 1 to port 3. Ids, bitwidths and the encoding of
+  // the values come from the bindings generated from ipv4_router.p4info.txt.
+  p4info::tables::Ipv4Lpm route;
+  route.vrf_id = 1;
+  route.hdr_ipv4_dst_addr = {0x0a000000, 8};
+  route.action = p4info::actions::SetNexthop{/*port=*/3,
+                                             /*dst_mac=*/0x001122334455};
+  p4::v1::TableEntry route_entry;
+  RETURN_IF_ERROR(route.ToProto(&route_entry));
+  std::cout << route_entry.DebugString() << std::endl;
+
+  // Drop traffic from 192.168.0.0/16 to the well-known ports. The port range
+  // is a don't-care match when left unset.
+  p4info::tables::Acl acl;
+  acl.hdr_ipv4_src_addr = {{0xc0a80000, 0xffff0000}};
+  acl.l4_dst_port = {{0, 1023}};
+  acl.priority = 10;
+  acl.action = p4info::actions::Drop{};
+  p4::v1::TableEntry acl_entry;
+  RETURN_IF_ERROR(acl.ToProto(&acl_entry));
+  std::cout << acl_entry.DebugString() << std::endl;
+
+  // Entries read from a switch convert back, e.g. to inspect their actions.
+  ASSIGN_OR_RETURN(p4info::tables::Ipv4Lpm read_route,
+                   p4info::tables::Ipv4Lpm::FromProto(route_entry));
+  const auto* set_nexthop =
+      absl::get_if<p4info::actions::SetNexthop>(&read_route.action);
+  if (set_nexthop == nullptr || set_nexthop->port != 3) {
+    return gutil::InternalErrorBuilder()
+           << "The route did not convert back to its proto.";
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace p4runtime_cpp_example
+
+int main() {
+  absl::Status status = p4runtime_cpp_example::Main();
+  if (!status.ok()) {
+    std::cerr << status << std::endl;
+  } else {
+    std::cout << "All done." << std::endl;
+  }
+  return status.raw_code();
+}
@@ -0,0 +1,41 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "gutil/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>  // NOLINT
+#include <vector>
+
+namespace gutil {
+
+absl::Status ParallelFor(int num_tasks, int num_threads,
+                         const std::function<absl::Status(int index)>& task) {
+  std::vector<absl::Status> statuses(std::max(num_tasks, 0));
+  std::atomic<int> next_index(0);
+  std::atomic<bool> failed(false);
+  auto worker = [&]() {
+    while (!failed.load(std::memory_order_relaxed)) {
+      const int index = next_index.fetch_add(1);
+      if (index >= num_tasks) return;
+      statuses[index] = task(index);
+      if (!statuses[index].ok()) failed.store(true);
+    }
+  };
+
+  // The calling thread is one of the workers.
+  std::vector<std::thread> threads;
+  for (int i = 1; i < std::min(num_threads, num_tasks); ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& thread : threads) thread.join();
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) return status;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace gutil
@@ -0,0 +1,21 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef GUTIL_PARALLEL_H_
+#define GUTIL_PARALLEL_H_
+
+#include <functional>
+
+#include "absl/status/status.h"
+
+namespace gutil {
+
+// Runs `task(index)` for every index in [0, num_tasks) on up to `num_threads`
+// threads and waits for all of them. Once a task has failed, no further tasks
+// are started. Returns the error of the failed task with the lowest index.
+absl::Status ParallelFor(int num_tasks, int num_threads,
+                         const std::function<absl::Status(int index)>& task);
+
+}  // namespace gutil
+
+#endif  // GUTIL_PARALLEL_H_
@@ -15,36 +15,53 @@
 #include "gutil/proto.h"
 
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
 #include "google/protobuf/descriptor.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "google/protobuf/io/zero_copy_stream_impl.h"
+#include "google/protobuf/io/zero_copy_stream_impl_lite.h"
 #include "google/protobuf/message.h"
 #include "google/protobuf/text_format.h"
 #include "gutil/status.h"
 
 namespace gutil {
 
+namespace {
+
+// The number of leading bytes DetectProtoFileFormat looks at.
+constexpr size_t kFormatDetectionBytes = 4096;
+
+}  // namespace
+
 absl::Status ReadProtoFromFile(absl::string_view filename,
                                google::protobuf::Message* message) {
   // Verifies that the version of the library that we linked against is
   // compatible with the version of the headers we compiled against.
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
-  int fd = open(std::string(filename).c_str(), O_RDONLY);
-  if (fd < 0) {
-    return InvalidArgumentErrorBuilder()
-           << "Error opening the file " << filename;
-  }
+  absl::StatusOr<MappedFile> file = MappedFile::Open(filename);
+  if (!file.ok()) return file.status();
 
-  google::protobuf::io::FileInputStream file_stream(fd);
-  file_stream.SetCloseOnDelete(true);
-
-  if (!google::protobuf::TextFormat::Parse(&file_stream, message)) {
+  google::protobuf::io::ArrayInputStream stream(file->contents().data(),
+                                                file->contents().size());
+  if (!google::protobuf::TextFormat::Parse(&stream, message)) {
     return InvalidArgumentErrorBuilder() << "Failed to parse file " << filename;
   }
 
@@ -57,8 +74,9 @@ absl::Status ReadProtoFromString(absl::string_view proto_string,
   // compatible with the version of the headers we compiled against.
   GOOGLE_PROTOBUF_VERIFY_VERSION;
 
-  if (!google::protobuf::TextFormat::ParseFromString(std::string(proto_string),
-                                                     message)) {
+  google::protobuf::io::ArrayInputStream stream(proto_string.data(),
+                                                proto_string.size());
+  if (!google::protobuf::TextFormat::Parse(&stream, message)) {
     return InvalidArgumentErrorBuilder()
            << "Failed to parse string " << proto_string;
   }
@@ -66,6 +84,186 @@ absl::Status ReadProtoFromString(absl::string_view proto_string,
   return absl::OkStatus();
 }
 
+absl::StatusOr<MappedFile> MappedFile::Open(absl::string_view filename) {
+  int fd = open(std::string(filename).c_str(), O_RDONLY);
+  if (fd < 0) {
+    return InvalidArgumentErrorBuilder()
+           << "Error opening the file " << filename << ": "
+           << std::strerror(errno);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    const int error = errno;
+    close(fd);
+    return InvalidArgumentErrorBuilder()
+           << "Error reading the file " << filename << ": "
+           << std::strerror(error);
+  }
+
+  MappedFile file;
+  // Pipes, /dev/stdin and the like cannot be mapped, and /proc files report
+  // no size, so these are read through a stream instead.
+  if (!S_ISREG(file_stat.st_mode) || file_stat.st_size == 0) {
+    google::protobuf::io::FileInputStream file_stream(fd);
+    file_stream.SetCloseOnDelete(true);
+    file.buffer_ = absl::make_unique<std::string>();
+    const void* data;
+    int size;
+    while (file_stream.Next(&data, &size)) {
+      file.buffer_->append(static_cast<const char*>(data), size);
+    }
+    if (file_stream.GetErrno() != 0) {
+      return InvalidArgumentErrorBuilder()
+             << "Error reading the file " << filename << ": "
+             << std::strerror(file_stream.GetErrno());
+    }
+    file.data_ = file.buffer_->data();
+    file.size_ = file.buffer_->size();
+    return file;
+  }
+
+  void* data = mmap(nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd,
+                    /*offset=*/0);
+  if (data == MAP_FAILED) {
+    const int error = errno;
+    close(fd);
+    return InvalidArgumentErrorBuilder()
+           << "Error mapping the file " << filename << ": "
+           << std::strerror(error);
+  }
+  // Readers go through the file front to back, so let the kernel read
+  // ahead. This is only a hint, so errors are ignored.
+  madvise(data, file_stat.st_size, MADV_SEQUENTIAL);
+  file.data_ = static_cast<const char*>(data);
+  file.size_ = file_stat.st_size;
+  // The mapping keeps the file open.
+  close(fd);
+  return file;
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      buffer_(std::move(other.buffer_)) {}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+  if (this != &other) {
+    Unmap();
+    data_ = std::exchange(other.data_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    buffer_ = std::move(other.buffer_);
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile() { Unmap(); }
+
+void MappedFile::Unmap() {
+  if (buffer_ == nullptr && data_ != nullptr) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+  buffer_.reset();
+}
+
+absl::string_view ConsumeTextProto(absl::string_view* text) {
+  // The current protobuf starts at `start` and ends with the last non-blank
+  // line at `end`.
+  size_t start = 0;
+  size_t end = 0;
+  bool has_content = false;
+  size_t pos = 0;
+  while (pos < text->size()) {
+    const size_t line_end = std::min(text->find('\n', pos), text->size());
+    const absl::string_view line = absl::StripLeadingAsciiWhitespace(
+        text->substr(pos, line_end - pos));
+    if (line.empty()) {
+      if (has_content) break;
+      start = line_end + 1;
+    } else {
+      has_content |= line.front() != '#';
+      end = line_end;
+    }
+    pos = line_end + 1;
+  }
+  const absl::string_view proto =
+      has_content ? text->substr(start, end - start) : absl::string_view();
+  text->remove_prefix(std::min(pos, text->size()));
+  return proto;
+}
+
+std::vector<absl::string_view> SplitTextProtos(absl::string_view text) {
+  std::vector<absl::string_view> protos;
+  while (true) {
+    const absl::string_view proto = ConsumeTextProto(&text);
+    if (proto.empty()) break;
+    protos.push_back(proto);
+  }
+  return protos;
+}
+
+ProtoFileFormat DetectProtoFileFormat(absl::string_view contents) {
+  for (const char c : contents.substr(0, kFormatDetectionBytes)) {
+    const unsigned char byte = static_cast<unsigned char>(c);
+    if ((byte < 0x20 && !absl::ascii_isspace(byte)) || byte == 0x7f) {
+      return ProtoFileFormat::kBinaryDelimited;
+    }
+  }
+  return ProtoFileFormat::kText;
+}
+
+absl::StatusOr<ProtoStreamReader> ProtoStreamReader::Open(
+    absl::string_view filename) {
+  absl::StatusOr<MappedFile> file = MappedFile::Open(filename);
+  if (!file.ok()) return file.status();
+  // The contents keep their address when the file is moved into the reader.
+  ProtoStreamReader reader(file->contents());
+  reader.file_ = *std::move(file);
+  return reader;
+}
+
+ProtoStreamReader::ProtoStreamReader(absl::string_view contents)
+    : remaining_(contents), format_(DetectProtoFileFormat(contents)) {}
+
+absl::StatusOr<bool> ProtoStreamReader::Next(
+    google::protobuf::Message* message) {
+  if (format_ == ProtoFileFormat::kText) {
+    const absl::string_view proto = ConsumeTextProto(&remaining_);
+    if (proto.empty()) return false;
+    message->Clear();
+    RETURN_IF_ERROR(ReadProtoFromString(proto, message)).SetPrepend()
+        << "Protobuf " << index_ << ": ";
+    ++index_;
+    return true;
+  }
+
+  if (remaining_.empty()) return false;
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(remaining_.data()),
+      std::min<size_t>(remaining_.size(), std::numeric_limits<int>::max()));
+  uint32_t size;
+  if (!input.ReadVarint32(&size)) {
+    return InvalidArgumentErrorBuilder()
+           << "Protobuf " << index_ << ": truncated size";
+  }
+  const size_t header_size = input.CurrentPosition();
+  if (size > remaining_.size() - header_size ||
+      size > static_cast<uint32_t>(std::numeric_limits<int>::max())) {
+    return InvalidArgumentErrorBuilder()
+           << "Protobuf " << index_ << ": size " << size << " exceeds the "
+           << remaining_.size() - header_size << " remaining bytes";
+  }
+  if (!message->ParseFromArray(remaining_.data() + header_size, size)) {
+    return InvalidArgumentErrorBuilder()
+           << "Protobuf " << index_ << ": failed to parse "
+           << message->GetDescriptor()->full_name();
+  }
+  remaining_.remove_prefix(header_size + size);
+  ++index_;
+  return true;
+}
+
 absl::StatusOr<std::string> GetOneOfFieldName(
     const google::protobuf::Message& message, const std::string& oneof_name) {
   const auto* oneof_descriptor =
@@ -15,7 +15,11 @@
 #ifndef GUTIL_PROTO_H_
 #define GUTIL_PROTO_H_
 
+#include <cstddef>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,14 +29,120 @@
 
 namespace gutil {
 
-// Read the contents of the file into a protobuf.
+// Read the contents of the file into a protobuf. The file is memory-mapped
+// and parsed in place.
 absl::Status ReadProtoFromFile(absl::string_view filename,
                                google::protobuf::Message* message);
 
-// Read the contents of the string into a protobuf.
+// Read the contents of the string into a protobuf, without copying it.
 absl::Status ReadProtoFromString(absl::string_view proto_string,
                                  google::protobuf::Message* message);
 
+// A read-only memory mapping of a whole file. The contents stay valid, at the
+// same address, until the MappedFile is destroyed, also across moves.
+class MappedFile {
+ public:
+  // Maps the file. Files that cannot be mapped or report no size, e.g. pipes,
+  // /dev/stdin or /proc files, are read into memory instead.
+  static absl::StatusOr<MappedFile> Open(absl::string_view filename);
+
+  MappedFile() = default;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile();
+
+  absl::string_view contents() const {
+    return absl::string_view(data_, size_);
+  }
+
+ private:
+  void Unmap();
+
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  // The contents of a file that is not mapped, if any.
+  std::unique_ptr<std::string> buffer_;
+};
+
+// Return the next text-format protobuf of `text` and remove it from `text`.
+// Protobufs are separated by blank lines; blocks that consist only of
+// whitespace and comments are skipped. Returns an empty view at the end.
+absl::string_view ConsumeTextProto(absl::string_view* text);
+
+// Split text into the text-format protobufs it contains, see ConsumeTextProto.
+// The results point into `text`.
+std::vector<absl::string_view> SplitTextProtos(absl::string_view text);
+
+enum class ProtoFileFormat {
+  // Text-format protobufs separated by blank lines.
+  kText,
+  // Binary protobufs, each preceded by its size as a varint, as written by
+  // google::protobuf::util::SerializeDelimitedToOstream.
+  kBinaryDelimited,
+};
+
+// Guess the format of a stream of protobufs from its contents. Binary protobufs
+// start with field tags, which are control characters for the low field
+// numbers of Entity, TableEntry, Update etc., while text has none except
+// whitespace.
+ProtoFileFormat DetectProtoFileFormat(absl::string_view contents);
+
+// Reads a stream of protobufs of one type, e.g. Entity, TableEntry or Update,
+// one at a time and without copying the input. The format is detected from the
+// contents.
+//
+//   absl::StatusOr<gutil::ProtoStreamReader> reader =
+//       gutil::ProtoStreamReader::Open(filename);
+//   if (!reader.ok()) return reader.status();
+//   p4::v1::Entity entity;
+//   while (true) {
+//     ASSIGN_OR_RETURN(bool has_entity, reader->Next(&entity));
+//     if (!has_entity) break;
+//     ...
+//   }
+class ProtoStreamReader {
+ public:
+  // Memory-maps the file and reads from it.
+  static absl::StatusOr<ProtoStreamReader> Open(absl::string_view filename);
+
+  // Reads from `contents`, which must outlive the reader.
+  explicit ProtoStreamReader(absl::string_view contents);
+
+  ProtoFileFormat format() const { return format_; }
+
+  // Parse the next protobuf into `message`, replacing its contents. Returns
+  // false at the end of the stream.
+  absl::StatusOr<bool> Next(google::protobuf::Message* message);
+
+ private:
+  MappedFile file_;
+  // The unread part of the stream.
+  absl::string_view remaining_;
+  ProtoFileFormat format_;
+  // The number of protobufs read so far, for error messages.
+  int index_ = 0;
+};
+
+// Read all protobufs of a file of either format into `messages`, see
+// ProtoStreamReader.
+template <typename T>
+absl::Status ReadProtosFromFile(absl::string_view filename,
+                                std::vector<T>* messages) {
+  absl::StatusOr<ProtoStreamReader> reader = ProtoStreamReader::Open(filename);
+  if (!reader.ok()) return reader.status();
+  messages->clear();
+  while (true) {
+    T message;
+    ASSIGN_OR_RETURN(bool has_message, reader->Next(&message),
+                     _.SetPrepend() << filename << ": ");
+    if (!has_message) break;
+    messages->push_back(std::move(message));
+  }
+  return absl::OkStatus();
+}
+
 // Get the name of the oneof enum that is set.
 // Eg:
 // message IrValue {
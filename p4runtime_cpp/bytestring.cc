@@ -0,0 +1,75 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/bytestring.h"
+
+#include <algorithm>
+
+namespace p4runtime_cpp {
+
+bool DecodeBytestring(absl::string_view bytes, int bitwidth, uint64_t* value) {
+  // Non-canonical byte strings may carry leading zeros.
+  while (bytes.size() > sizeof(uint64_t)) {
+    if (bytes.front() != '\0') return false;
+    bytes.remove_prefix(1);
+  }
+  uint64_t result = 0;
+  for (char byte : bytes) {
+    result = (result << 8) | static_cast<uint8_t>(byte);
+  }
+  if (bitwidth < 64 && (result >> bitwidth) != 0) return false;
+  *value = result;
+  return true;
+}
+
+bool EncodeBytestring(uint64_t value, int bitwidth, std::string* bytes) {
+  if (bitwidth < 64 && (value >> bitwidth) != 0) return false;
+  char buffer[sizeof(uint64_t)];
+  int start = sizeof(buffer);
+  do {
+    buffer[--start] = static_cast<char>(value & 0xff);
+    value >>= 8;
+  } while (value != 0);
+  bytes->assign(buffer + start, sizeof(buffer) - start);
+  return true;
+}
+
+bool CanonicalizeBytestring(absl::string_view bytes, int bitwidth,
+                            std::string* canonical) {
+  while (bytes.size() > 1 && bytes.front() == '\0') bytes.remove_prefix(1);
+  if (bytes.empty()) {
+    canonical->assign(1, '\0');
+    return true;
+  }
+  // The number of significant bits in the leading byte.
+  int leading_bits = 0;
+  for (int byte = static_cast<uint8_t>(bytes.front()); byte != 0; byte >>= 1) {
+    ++leading_bits;
+  }
+  const int64_t significant_bits =
+      static_cast<int64_t>(bytes.size() - 1) * 8 + leading_bits;
+  if (significant_bits > bitwidth) return false;
+  canonical->assign(bytes.data(), bytes.size());
+  return true;
+}
+
+void ClearBytestringLowBits(int bits, std::string* bytes) {
+  for (auto byte = bytes->rbegin(); byte != bytes->rend() && bits > 0;
+       ++byte, bits -= 8) {
+    *byte = bits >= 8 ? 0 : static_cast<char>(*byte & (0xff << bits));
+  }
+}
+
+void MaskBytestring(absl::string_view mask, std::string* bytes) {
+  auto mask_byte = mask.rbegin();
+  for (auto byte = bytes->rbegin(); byte != bytes->rend(); ++byte) {
+    *byte = mask_byte == mask.rend() ? 0 : (*byte & *mask_byte++);
+  }
+}
+
+bool IsZeroBytestring(absl::string_view bytes) {
+  return std::all_of(bytes.begin(), bytes.end(),
+                     [](char byte) { return byte == '\0'; });
+}
+
+}  // namespace p4runtime_cpp
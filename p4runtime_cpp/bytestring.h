@@ -0,0 +1,42 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_BYTESTRING_H_
+#define P4RUNTIME_CPP_BYTESTRING_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace p4runtime_cpp {
+
+// Decode a P4Runtime byte string, i.e. a big-endian unsigned integer, of a
+// field of the given bitwidth (at most 64). Leading zero bytes are accepted.
+// Returns false if the value does not fit into the bitwidth.
+bool DecodeBytestring(absl::string_view bytes, int bitwidth, uint64_t* value);
+
+// Encode the value of a field of the given bitwidth (at most 64) as a canonical
+// P4Runtime byte string, i.e. without leading zero bytes; 0 is encoded as a
+// single zero byte. Returns false if the value does not fit into the bitwidth.
+bool EncodeBytestring(uint64_t value, int bitwidth, std::string* bytes);
+
+// Convert a big-endian byte string of a field of the given bitwidth into its
+// canonical form. Returns false if the value does not fit into the bitwidth.
+bool CanonicalizeBytestring(absl::string_view bytes, int bitwidth,
+                            std::string* canonical);
+
+// Clear the lowest `bits` bits of a big-endian byte string, e.g. the host bits
+// of an LPM value. The result may have leading zero bytes.
+void ClearBytestringLowBits(int bits, std::string* bytes);
+
+// AND a big-endian byte string with the mask, aligning them at their least
+// significant byte. The result may have leading zero bytes.
+void MaskBytestring(absl::string_view mask, std::string* bytes);
+
+// Whether all bytes of the byte string are zero, e.g. of a don't-care mask.
+bool IsZeroBytestring(absl::string_view bytes);
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_BYTESTRING_H_
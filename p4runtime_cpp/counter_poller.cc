@@ -0,0 +1,292 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/counter_poller.h"
+
+#include <algorithm>
+#include <functional>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "glog/logging.h"
+#include "gutil/status.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::CounterData;
+using ::p4::v1::Entity;
+using ::p4::v1::ReadRequest;
+
+namespace {
+
+// Computes deltas of `current` over `previous` and the corresponding rates.
+// Kept free of branches and aliasing, so that the compiler vectorizes it.
+void ComputeDeltas(const uint64_t* __restrict previous,
+                   const uint64_t* __restrict current, int size,
+                   double rate_factor, uint64_t* __restrict deltas,
+                   double* __restrict rates) {
+  for (int i = 0; i < size; ++i) {
+    // A counter that went backwards has been reset.
+    deltas[i] = current[i] >= previous[i] ? current[i] - previous[i]
+                                          : current[i];
+  }
+  for (int i = 0; i < size; ++i) {
+    rates[i] = static_cast<double>(deltas[i]) * rate_factor;
+  }
+}
+
+// Computes the deltas and rates of the series against the previous counts of
+// its slots.
+void ComputeDeltas(const std::vector<uint64_t>& previous_bytes,
+                   const std::vector<uint64_t>& previous_packets,
+                   double rate_factor, CounterSeries* series) {
+  const int size = series->Size();
+  series->byte_deltas.resize(size);
+  series->packet_deltas.resize(size);
+  series->byte_rates.resize(size);
+  series->packet_rates.resize(size);
+  ComputeDeltas(previous_bytes.data(), series->byte_counts.data(), size,
+                rate_factor, series->byte_deltas.data(),
+                series->byte_rates.data());
+  ComputeDeltas(previous_packets.data(), series->packet_counts.data(), size,
+                rate_factor, series->packet_deltas.data(),
+                series->packet_rates.data());
+}
+
+// The slot of every entry key of a series, referring to the keys in place.
+using SlotMap =
+    absl::flat_hash_map<std::reference_wrapper<const p4::v1::TableEntry>, int,
+                        TableEntryKeyHash, TableEntryKeyEq>;
+
+void SetSample(int slot, const CounterData& data, CounterSeries* series) {
+  series->byte_counts[slot] = data.byte_count();
+  series->packet_counts[slot] = data.packet_count();
+}
+
+}  // namespace
+
+CounterPoller::CounterPoller(P4RuntimeSession* session, Options options)
+    : session_(session), options_(std::move(options)) {}
+
+absl::StatusOr<std::unique_ptr<CounterPoller>> CounterPoller::Create(
+    P4RuntimeSession* session, Options options) {
+  // Using `new` to access a private constructor.
+  std::unique_ptr<CounterPoller> poller =
+      absl::WrapUnique(new CounterPoller(session, std::move(options)));
+  for (uint32_t counter_id : poller->options_.counter_ids) {
+    if (!poller->counter_index_
+             .emplace(counter_id, poller->counter_index_.size())
+             .second) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Duplicate counter id " << counter_id << ".";
+    }
+  }
+  for (uint32_t table_id : poller->options_.direct_counter_table_ids) {
+    if (!poller->table_index_.emplace(table_id, poller->table_index_.size())
+             .second) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Duplicate table id " << table_id << ".";
+    }
+  }
+  if (poller->options_.interval > absl::ZeroDuration()) {
+    poller->poll_thread_ =
+        std::thread([poller = poller.get()]() { poller->PollLoop(); });
+  }
+  // Move is needed to make the older compiler happy.
+  return std::move(poller);
+}
+
+CounterPoller::~CounterPoller() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  if (poll_thread_.joinable()) poll_thread_.join();
+}
+
+std::shared_ptr<const CounterSnapshot> CounterPoller::Latest() const {
+  absl::MutexLock lock(&mutex_);
+  return latest_;
+}
+
+absl::Status CounterPoller::PollOnce() {
+  absl::MutexLock poll_lock(&poll_mutex_);
+  const std::shared_ptr<const CounterSnapshot> previous = Latest();
+
+  auto snapshot = std::make_shared<CounterSnapshot>();
+  snapshot->counters.resize(options_.counter_ids.size());
+  snapshot->direct_counters.resize(options_.direct_counter_table_ids.size());
+
+  ReadRequest read_request;
+  read_request.set_device_id(session_->DeviceId());
+  for (int i = 0; i < static_cast<int>(snapshot->counters.size()); ++i) {
+    CounterSeries& series = snapshot->counters[i];
+    series.id = options_.counter_ids[i];
+    // Counters rarely change their size, so this usually avoids growing the
+    // arrays while reading.
+    if (previous != nullptr) {
+      series.byte_counts.resize(previous->counters[i].Size());
+      series.packet_counts.resize(previous->counters[i].Size());
+    }
+    read_request.add_entities()->mutable_counter_entry()->set_counter_id(
+        series.id);
+  }
+  for (int i = 0; i < static_cast<int>(snapshot->direct_counters.size()); ++i) {
+    CounterSeries& series = snapshot->direct_counters[i];
+    series.id = options_.direct_counter_table_ids[i];
+    // Start out with the keys of the previous poll, which are only replaced
+    // if the entries of the table have changed since.
+    if (previous != nullptr) {
+      series.keys = previous->direct_counters[i].keys;
+      series.byte_counts.reserve(series.keys->size());
+      series.packet_counts.reserve(series.keys->size());
+    }
+    p4::v1::TableEntry* table_entry =
+        read_request.add_entities()->mutable_table_entry();
+    table_entry->set_table_id(series.id);
+    table_entry->mutable_counter_data();
+  }
+
+  // The keys of every table whose entries differ from the previous poll, from
+  // the first entry that differs on. nullptr while they are the same.
+  std::vector<std::shared_ptr<std::vector<TableEntryKey>>> changed_keys(
+      snapshot->direct_counters.size());
+
+  snapshot->time = absl::Now();
+  RETURN_IF_ERROR(SendReadRequest(
+      session_, read_request, [&](Entity* entity) -> absl::Status {
+        if (entity->has_counter_entry()) {
+          const p4::v1::CounterEntry& entry = entity->counter_entry();
+          auto it = counter_index_.find(entry.counter_id());
+          if (it == counter_index_.end()) return absl::OkStatus();
+          CounterSeries& series = snapshot->counters[it->second];
+          const int64_t index = entry.index().index();
+          if (index < 0) {
+            return gutil::InternalErrorBuilder()
+                   << "Counter entry in the read response has a negative "
+                      "index: "
+                   << entity->ShortDebugString();
+          }
+          if (index >= series.Size()) {
+            series.byte_counts.resize(index + 1);
+            series.packet_counts.resize(index + 1);
+          }
+          SetSample(index, entry.data(), &series);
+        } else if (entity->has_table_entry()) {
+          const p4::v1::TableEntry& entry = entity->table_entry();
+          auto it = table_index_.find(entry.table_id());
+          if (it == table_index_.end()) return absl::OkStatus();
+          CounterSeries& series = snapshot->direct_counters[it->second];
+          auto& changed = changed_keys[it->second];
+          const int slot = series.Size();
+          if (changed == nullptr &&
+              (series.keys == nullptr ||
+               slot >= static_cast<int>(series.keys->size()) ||
+               !TableEntryKeyEq()((*series.keys)[slot], entry))) {
+            changed = std::make_shared<std::vector<TableEntryKey>>();
+            if (series.keys != nullptr) {
+              changed->reserve(series.keys->size());
+              changed->assign(series.keys->begin(),
+                              series.keys->begin() + slot);
+            }
+          }
+          if (changed != nullptr) changed->emplace_back(entry);
+          series.byte_counts.push_back(entry.counter_data().byte_count());
+          series.packet_counts.push_back(entry.counter_data().packet_count());
+        } else {
+          return gutil::InternalErrorBuilder()
+                 << "Entity in the read response is neither a counter nor a "
+                    "table entry: "
+                 << entity->ShortDebugString();
+        }
+        return absl::OkStatus();
+      }));
+
+  if (previous != nullptr) {
+    snapshot->interval = snapshot->time - previous->time;
+  }
+  const double seconds = absl::ToDoubleSeconds(snapshot->interval);
+  const double rate_factor = seconds > 0 ? 1 / seconds : 0;
+
+  // Indirect counters line up by index. Indices that are new compare against
+  // themselves, i.e. have a delta of 0.
+  for (int i = 0; i < static_cast<int>(snapshot->counters.size()); ++i) {
+    CounterSeries& series = snapshot->counters[i];
+    std::vector<uint64_t> previous_bytes = series.byte_counts;
+    std::vector<uint64_t> previous_packets = series.packet_counts;
+    if (previous != nullptr) {
+      const CounterSeries& previous_series = previous->counters[i];
+      const int size = std::min(series.Size(), previous_series.Size());
+      std::copy_n(previous_series.byte_counts.begin(), size,
+                  previous_bytes.begin());
+      std::copy_n(previous_series.packet_counts.begin(), size,
+                  previous_packets.begin());
+    }
+    ComputeDeltas(previous_bytes, previous_packets, rate_factor, &series);
+  }
+
+  // Direct counters line up by slot while the entries of the table are
+  // unchanged. Otherwise they are matched up by entry key, gathering the
+  // previous counts into slot order first.
+  for (int i = 0; i < static_cast<int>(snapshot->direct_counters.size()); ++i) {
+    CounterSeries& series = snapshot->direct_counters[i];
+    if (changed_keys[i] == nullptr && series.keys != nullptr &&
+        static_cast<int>(series.keys->size()) == series.Size()) {
+      const CounterSeries& previous_series = previous->direct_counters[i];
+      ComputeDeltas(previous_series.byte_counts,
+                    previous_series.packet_counts, rate_factor, &series);
+      continue;
+    }
+    if (changed_keys[i] == nullptr) {
+      // Entries were only removed from the end, or there are none.
+      changed_keys[i] = std::make_shared<std::vector<TableEntryKey>>();
+      if (series.keys != nullptr) {
+        changed_keys[i]->assign(series.keys->begin(),
+                                series.keys->begin() + series.Size());
+      }
+    }
+    series.keys = std::move(changed_keys[i]);
+    std::vector<uint64_t> previous_bytes = series.byte_counts;
+    std::vector<uint64_t> previous_packets = series.packet_counts;
+    if (previous != nullptr) {
+      const CounterSeries& previous_series = previous->direct_counters[i];
+      SlotMap previous_slots;
+      previous_slots.reserve(previous_series.Size());
+      for (int slot = 0; slot < previous_series.Size(); ++slot) {
+        previous_slots.emplace((*previous_series.keys)[slot].Entry(), slot);
+      }
+      for (int slot = 0; slot < series.Size(); ++slot) {
+        auto it = previous_slots.find((*series.keys)[slot].Entry());
+        if (it == previous_slots.end()) continue;
+        previous_bytes[slot] = previous_series.byte_counts[it->second];
+        previous_packets[slot] = previous_series.packet_counts[it->second];
+      }
+    }
+    ComputeDeltas(previous_bytes, previous_packets, rate_factor, &series);
+  }
+
+  absl::MutexLock lock(&mutex_);
+  latest_ = std::move(snapshot);
+  return absl::OkStatus();
+}
+
+void CounterPoller::PollLoop() {
+  absl::Time next_poll = absl::Now();
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.AwaitWithDeadline(absl::Condition(&shutdown_), next_poll);
+      if (shutdown_) return;
+    }
+    next_poll += options_.interval;
+    absl::Status status = PollOnce();
+    if (!status.ok()) {
+      LOG(WARNING) << "Failed to poll counters: " << status;
+    }
+    // Skip the polls that a slow poll has overrun, rather than catching up.
+    const absl::Time now = absl::Now();
+    if (next_poll < now) next_poll = now;
+  }
+}
+
+}  // namespace p4runtime_cpp
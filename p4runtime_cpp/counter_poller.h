@@ -0,0 +1,111 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_COUNTER_POLLER_H_
+#define P4RUNTIME_CPP_COUNTER_POLLER_H_
+
+#include <cstdint>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+#include "p4runtime_cpp/table_entry_key.h"
+
+namespace p4runtime_cpp {
+
+// The samples of one indirect counter, or of the direct counters of one table,
+// as parallel arrays indexed by slot. For an indirect counter the slot is the
+// counter index; indices that the switch did not report read as 0. For direct
+// counters the slot is the position of the entry in the read response, and
+// `keys` holds the key of the entry of every slot.
+struct CounterSeries {
+  // The counter id, or the table id for direct counters.
+  uint32_t id = 0;
+  // Only for direct counters. Shared with the previous snapshot while the
+  // entries of the table are unchanged.
+  std::shared_ptr<const std::vector<TableEntryKey>> keys;
+
+  std::vector<uint64_t> byte_counts;
+  std::vector<uint64_t> packet_counts;
+  // The increase since the previous snapshot. 0 for slots that are new, and
+  // the full count for counters that have been reset.
+  std::vector<uint64_t> byte_deltas;
+  std::vector<uint64_t> packet_deltas;
+  // The deltas per second of the interval between the snapshots.
+  std::vector<double> byte_rates;
+  std::vector<double> packet_rates;
+
+  int Size() const { return byte_counts.size(); }
+};
+
+// The counters read by one poll. Immutable once published.
+struct CounterSnapshot {
+  // When the counters were read.
+  absl::Time time;
+  // The time since the previous snapshot, or zero for the first one.
+  absl::Duration interval;
+  // In the order of CounterPoller::Options.
+  std::vector<CounterSeries> counters;
+  std::vector<CounterSeries> direct_counters;
+};
+
+// Reads a fixed set of indirect counters and direct table counters on an
+// interval, all with a single read request, and publishes each poll as an
+// immutable snapshot with the deltas and rates since the previous one.
+class CounterPoller {
+ public:
+  struct Options {
+    // The ids of the indirect counters to read.
+    std::vector<uint32_t> counter_ids;
+    // The ids of the tables whose direct counters to read.
+    std::vector<uint32_t> direct_counter_table_ids;
+    // How often to poll. A zero interval disables polling in the background;
+    // use PollOnce instead.
+    absl::Duration interval = absl::Seconds(5);
+  };
+
+  // Creates a poller for the session, which must outlive it.
+  static absl::StatusOr<std::unique_ptr<CounterPoller>> Create(
+      P4RuntimeSession* session, Options options);
+  ~CounterPoller();
+
+  // Disable copy semantics.
+  CounterPoller(const CounterPoller&) = delete;
+  CounterPoller& operator=(const CounterPoller&) = delete;
+
+  // Reads all counters now and publishes the result.
+  absl::Status PollOnce();
+
+  // Returns the latest snapshot, or nullptr before the first successful poll.
+  std::shared_ptr<const CounterSnapshot> Latest() const;
+
+ private:
+  CounterPoller(P4RuntimeSession* session, Options options);
+
+  // Polls on the interval until the poller is destroyed.
+  void PollLoop();
+
+  P4RuntimeSession* session_;
+  const Options options_;
+  // The index into the series of a snapshot of every counter and table id.
+  absl::flat_hash_map<uint32_t, int> counter_index_;
+  absl::flat_hash_map<uint32_t, int> table_index_;
+
+  // Serializes polls.
+  absl::Mutex poll_mutex_ ABSL_ACQUIRED_BEFORE(mutex_);
+
+  mutable absl::Mutex mutex_;
+  std::shared_ptr<const CounterSnapshot> latest_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::thread poll_thread_;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_COUNTER_POLLER_H_
@@ -0,0 +1,242 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/digest.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "glog/logging.h"
+#include "gutil/status.h"
+#include "p4runtime_cpp/bytestring.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::config::v1::P4BitstringLikeTypeSpec;
+using ::p4::config::v1::P4DataTypeSpec;
+using ::p4::config::v1::P4Info;
+using ::p4::v1::DigestList;
+using ::p4::v1::P4Data;
+
+namespace {
+
+// Returns the bitwidth of a member of the given type.
+absl::StatusOr<int> MemberBitwidth(const P4DataTypeSpec& type_spec) {
+  if (!type_spec.has_bitstring()) {
+    return gutil::UnimplementedErrorBuilder()
+           << "Unsupported digest member type: "
+           << type_spec.ShortDebugString();
+  }
+  const P4BitstringLikeTypeSpec& bitstring = type_spec.bitstring();
+  switch (bitstring.type_spec_case()) {
+    case P4BitstringLikeTypeSpec::kBit:
+      return bitstring.bit().bitwidth();
+    case P4BitstringLikeTypeSpec::kInt:
+      return bitstring.int_().bitwidth();
+    case P4BitstringLikeTypeSpec::kVarbit:
+      return bitstring.varbit().max_bitwidth();
+    default:
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Invalid bitstring type: " << bitstring.ShortDebugString();
+  }
+}
+
+absl::Status AddMember(const std::string& name,
+                       const P4DataTypeSpec& type_spec, DigestLayout* layout) {
+  if (type_spec.has_bool_()) {
+    layout->members.push_back({name, 1, /*is_bool=*/true});
+    return absl::OkStatus();
+  }
+  ASSIGN_OR_RETURN(int bitwidth, MemberBitwidth(type_spec));
+  layout->members.push_back({name, bitwidth, /*is_bool=*/false});
+  return absl::OkStatus();
+}
+
+absl::StatusOr<DigestLayout> BuildLayout(const P4Info& p4info,
+                                         const p4::config::v1::Digest& digest) {
+  DigestLayout layout;
+  layout.digest_id = digest.preamble().id();
+  layout.name = digest.preamble().name();
+  layout.alias = digest.preamble().alias();
+  const P4DataTypeSpec& type_spec = digest.type_spec();
+  if (type_spec.has_struct_()) {
+    const auto& structs = p4info.type_info().structs();
+    auto it = structs.find(type_spec.struct_().name());
+    if (it == structs.end()) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Struct '" << type_spec.struct_().name() << "' of digest '"
+             << layout.name << "' is missing from the P4Info type info.";
+    }
+    layout.is_struct_like = true;
+    for (const auto& member : it->second.members()) {
+      RETURN_IF_ERROR(AddMember(member.name(), member.type_spec(), &layout))
+          << " In digest '" << layout.name << "'.";
+    }
+  } else if (type_spec.has_tuple()) {
+    layout.is_struct_like = true;
+    for (int i = 0; i < type_spec.tuple().members_size(); ++i) {
+      RETURN_IF_ERROR(AddMember(absl::StrCat(i), type_spec.tuple().members(i),
+                                &layout))
+          << " In digest '" << layout.name << "'.";
+    }
+  } else {
+    layout.is_struct_like = false;
+    RETURN_IF_ERROR(AddMember(layout.name, type_spec, &layout))
+        << " In digest '" << layout.name << "'.";
+  }
+  return layout;
+}
+
+// Returns true if the data has the type of the member.
+bool MatchesMember(const P4Data& data, const DigestLayout::Member& member) {
+  if (member.is_bool) return data.data_case() == P4Data::kBool;
+  if (data.data_case() != P4Data::kBitstring) return false;
+  const std::string& bytes = data.bitstring();
+  // Wide members are only checked for their size.
+  if (member.bitwidth > 64) {
+    return bytes.size() <= static_cast<size_t>((member.bitwidth + 7) / 8);
+  }
+  uint64_t value;
+  return DecodeBytestring(bytes, member.bitwidth, &value);
+}
+
+}  // namespace
+
+absl::StatusOr<DigestDecoder> DigestDecoder::Create(const P4Info& p4info) {
+  DigestDecoder decoder;
+  for (const auto& digest : p4info.digests()) {
+    ASSIGN_OR_RETURN(DigestLayout layout, BuildLayout(p4info, digest));
+    decoder.layout_by_id_.emplace_back(layout.digest_id,
+                                       decoder.layouts_.size());
+    decoder.layouts_.push_back(std::move(layout));
+  }
+  std::sort(decoder.layout_by_id_.begin(), decoder.layout_by_id_.end());
+  return decoder;
+}
+
+absl::StatusOr<const DigestLayout*> DigestDecoder::GetLayout(
+    absl::string_view name) const {
+  for (const DigestLayout& layout : layouts_) {
+    if (layout.name == name ||
+        (!layout.alias.empty() && layout.alias == name)) {
+      return &layout;
+    }
+  }
+  return gutil::NotFoundErrorBuilder()
+         << "No digest named '" << name << "' in the P4Info.";
+}
+
+absl::StatusOr<int> DigestDecoder::MemberSlot(
+    const DigestLayout& layout, absl::string_view member_name) const {
+  for (int slot = 0; slot < static_cast<int>(layout.members.size()); ++slot) {
+    if (layout.members[slot].name == member_name) return slot;
+  }
+  return gutil::NotFoundErrorBuilder() << "Digest '" << layout.name
+                                       << "' has no member '" << member_name
+                                       << "'.";
+}
+
+absl::Status DigestDecoder::Decode(const DigestList& list,
+                                   DigestListView* view) const {
+  auto it = std::lower_bound(
+      layout_by_id_.begin(), layout_by_id_.end(),
+      std::make_pair(list.digest_id(), 0));
+  if (it == layout_by_id_.end() || it->first != list.digest_id()) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Unknown digest id " << list.digest_id() << ".";
+  }
+  const DigestLayout& layout = layouts_[it->second];
+  view->layout_ = &layout;
+  view->list_ = &list;
+
+  const int num_members = layout.members.size();
+  for (int entry = 0; entry < list.data_size(); ++entry) {
+    const P4Data& data = list.data(entry);
+    if (layout.is_struct_like) {
+      const auto& members = data.data_case() == P4Data::kStruct
+                                ? data.struct_().members()
+                                : data.tuple().members();
+      if (members.size() != num_members) {
+        return gutil::InvalidArgumentErrorBuilder()
+               << "Entry " << entry << " of digest list " << list.list_id()
+               << " has " << members.size() << " members, but digest '"
+               << layout.name << "' has " << num_members << ".";
+      }
+    }
+    for (int member = 0; member < num_members; ++member) {
+      if (!MatchesMember(view->Member(entry, member), layout.members[member])) {
+        return gutil::InvalidArgumentErrorBuilder()
+               << "Member '" << layout.members[member].name << "' of entry "
+               << entry << " of digest list " << list.list_id()
+               << " does not match its type.";
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+const P4Data& DigestListView::Member(int entry, int member) const {
+  const P4Data& data = list_->data(entry);
+  if (!layout_->is_struct_like) return data;
+  return data.data_case() == P4Data::kStruct ? data.struct_().members(member)
+                                             : data.tuple().members(member);
+}
+
+absl::string_view DigestListView::MemberBytes(int entry, int member) const {
+  return Member(entry, member).bitstring();
+}
+
+uint64_t DigestListView::MemberValue(int entry, int member) const {
+  const P4Data& data = Member(entry, member);
+  if (data.data_case() == P4Data::kBool) return data.bool_();
+  uint64_t value = 0;
+  DecodeBytestring(data.bitstring(), 64, &value);
+  return value;
+}
+
+absl::Status RegisterDigestHandler(P4RuntimeSession* session,
+                                   DigestDecoder decoder,
+                                   DigestListHandler handler,
+                                   int queue_capacity) {
+  return session->RegisterStreamMessageHandler(
+      p4::v1::StreamMessageResponse::kDigest,
+      [session, decoder = std::move(decoder), handler = std::move(handler)](
+          const p4::v1::StreamMessageResponse& message) {
+        const DigestList& list = message.digest();
+        DigestListView view;
+        absl::Status status = decoder.Decode(list, &view);
+        if (status.ok()) {
+          handler(view);
+        } else {
+          LOG_EVERY_N(WARNING, 100) << "Dropped digest list: " << status;
+        }
+
+        p4::v1::StreamMessageRequest ack;
+        ack.mutable_digest_ack()->set_digest_id(list.digest_id());
+        ack.mutable_digest_ack()->set_list_id(list.list_id());
+        status = session->SendStreamMessage(std::move(ack));
+        if (!status.ok()) {
+          LOG_EVERY_N(WARNING, 100)
+              << "Unable to acknowledge digest list " << list.list_id() << ": "
+              << status;
+        }
+      },
+      queue_capacity);
+}
+
+absl::Status EnableDigest(P4RuntimeSession* session, uint32_t digest_id,
+                          const p4::v1::DigestEntry::Config& config) {
+  p4::v1::WriteRequest request;
+  request.set_device_id(session->DeviceId());
+  *request.mutable_election_id() = session->ElectionId();
+  p4::v1::Update* update = request.add_updates();
+  update->set_type(p4::v1::Update::INSERT);
+  p4::v1::DigestEntry* digest_entry =
+      update->mutable_entity()->mutable_digest_entry();
+  digest_entry->set_digest_id(digest_id);
+  *digest_entry->mutable_config() = config;
+  return SendWriteRequest(session, request);
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,107 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_DIGEST_H_
+#define P4RUNTIME_CPP_DIGEST_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+namespace p4runtime_cpp {
+
+// The layout of the data of a digest: a struct or tuple of bitstrings and
+// bools, or a single bitstring.
+struct DigestLayout {
+  uint32_t digest_id;
+  std::string name;
+  std::string alias;
+  // True if the data is a struct or tuple, false for a single bitstring.
+  bool is_struct_like;
+  struct Member {
+    std::string name;
+    // Bools have a bitwidth of 1; varbits have their maximum bitwidth.
+    int bitwidth;
+    bool is_bool;
+  };
+  // The members in declaration order; a single bitstring is one member named
+  // after the digest.
+  std::vector<Member> members;
+};
+
+// A view of a validated digest list. Members are read in place from the list,
+// which must outlive the view.
+class DigestListView {
+ public:
+  const DigestLayout& Layout() const { return *layout_; }
+  const p4::v1::DigestList& List() const { return *list_; }
+
+  int NumEntries() const { return list_->data_size(); }
+  // Return the raw bytes of the member of the given entry; empty for bools.
+  absl::string_view MemberBytes(int entry, int member) const;
+  // Return the value of the member of the given entry. Only meaningful for
+  // members of at most 64 bits; use MemberBytes for wider ones.
+  uint64_t MemberValue(int entry, int member) const;
+
+ private:
+  friend class DigestDecoder;
+
+  const p4::v1::P4Data& Member(int entry, int member) const;
+
+  const DigestLayout* layout_ = nullptr;
+  const p4::v1::DigestList* list_ = nullptr;
+};
+
+// Decodes the digest lists of all digests of a P4Info. The layout of every
+// digest is resolved once, so that decoding a list merely validates its shape
+// and neither allocates nor copies per entry. Immutable, and so safe to share
+// between threads.
+class DigestDecoder {
+ public:
+  static absl::StatusOr<DigestDecoder> Create(
+      const p4::config::v1::P4Info& p4info);
+
+  // Return the layout of the digest with the given name or alias.
+  absl::StatusOr<const DigestLayout*> GetLayout(absl::string_view name) const;
+  // Return the slot of the named member of the digest.
+  absl::StatusOr<int> MemberSlot(const DigestLayout& layout,
+                                 absl::string_view member_name) const;
+
+  // Validate the list against the layout of its digest and point `view` at it.
+  absl::Status Decode(const p4::v1::DigestList& list,
+                      DigestListView* view) const;
+
+ private:
+  DigestDecoder() = default;
+
+  std::vector<DigestLayout> layouts_;
+  // Index into `layouts_` of every digest id, sorted by id.
+  std::vector<std::pair<uint32_t, int>> layout_by_id_;
+};
+
+// Invoked for every digest list, with the list as a whole.
+using DigestListHandler = std::function<void(const DigestListView& list)>;
+
+// Register a handler for the digest lists received by the session. Every list
+// is acknowledged on the stream channel once the handler returns, including
+// lists that cannot be decoded, which are logged and dropped.
+absl::Status RegisterDigestHandler(P4RuntimeSession* session,
+                                   DigestDecoder decoder,
+                                   DigestListHandler handler,
+                                   int queue_capacity = 1024);
+
+// Enable the generation of digest lists by the switch for the given digest.
+absl::Status EnableDigest(P4RuntimeSession* session, uint32_t digest_id,
+                          const p4::v1::DigestEntry::Config& config);
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_DIGEST_H_
@@ -4,14 +4,23 @@
 
 #include "p4runtime_cpp/entity_management.h"
 
+#include <algorithm>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
-#include "absl/strings/str_replace.h"
+#include "google/protobuf/text_format.h"
 #include "gtl/map_util.h"
+#include "gutil/parallel.h"
 #include "gutil/proto.h"
 
 namespace p4runtime_cpp {
 
+using ::google::protobuf::TextFormat;
 using ::p4::config::v1::P4Info;
+using ::p4::v1::TableEntry;
 
 absl::Status BuildP4RTEntityIdReplacementMap(
     const P4Info& p4_info,
@@ -55,21 +64,493 @@ absl::Status BuildP4RTEntityIdReplacementMap(
   return absl::OkStatus();
 }
 
+namespace {
+
+// Placeholders are numbered below this bound, so that the number of values
+// cannot overflow.
+constexpr int kMaxPlaceholders = 1 << 16;
+
+// Returns the length of the `{name}` token at the start of `text`, or 0 if
+// there is none. Names contain neither braces nor whitespace, which tells them
+// apart from the braces of the text format.
+size_t TokenLength(absl::string_view text) {
+  for (size_t i = 1; i < text.size(); ++i) {
+    const char c = text[i];
+    if (c == '}') return i > 1 ? i + 1 : 0;
+    if (c == '{' || absl::ascii_isspace(c)) return 0;
+  }
+  return 0;
+}
+
+// Appends `text` to `output`, with every token that is in `replacements`
+// replaced.
+void AppendHydrated(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::string_view text, std::string* output) {
+  size_t literal_start = 0;
+  size_t pos = 0;
+  while ((pos = text.find('{', pos)) != absl::string_view::npos) {
+    const size_t length = TokenLength(text.substr(pos));
+    if (length == 0) {
+      ++pos;
+      continue;
+    }
+    auto replacement = replacements.find(text.substr(pos, length));
+    if (replacement != replacements.end()) {
+      output->append(text.data() + literal_start, pos - literal_start);
+      output->append(replacement->second);
+      literal_start = pos + length;
+    }
+    pos += length;
+  }
+  output->append(text.data() + literal_start, text.size() - literal_start);
+}
+
+}  // namespace
+
 absl::Status HydrateP4RuntimeProtoFromString(
     const absl::flat_hash_map<std::string, std::string>& replacements,
-    std::string proto_string, ::google::protobuf::Message* message) {
-  absl::StrReplaceAll(replacements, &proto_string);
-  RETURN_IF_ERROR(gutil::ReadProtoFromString(proto_string, message));
+    absl::string_view proto_string, ::google::protobuf::Message* message) {
+  std::string hydrated;
+  hydrated.reserve(proto_string.size());
+  AppendHydrated(replacements, proto_string, &hydrated);
+  RETURN_IF_ERROR(gutil::ReadProtoFromString(hydrated, message));
 
   return absl::OkStatus();
 }
 
 absl::Status HydrateP4RuntimeProtoFromString(
-    const P4Info& p4_info, std::string proto_string,
+    const P4Info& p4_info, absl::string_view proto_string,
     ::google::protobuf::Message* message) {
   absl::flat_hash_map<std::string, std::string> replacements;
   RETURN_IF_ERROR(BuildP4RTEntityIdReplacementMap(p4_info, &replacements));
   return HydrateP4RuntimeProtoFromString(replacements, proto_string, message);
 }
 
+absl::Status HydrateP4RuntimeProtosFromStrings(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::Span<const absl::string_view> proto_strings,
+    const ParallelHydrationOptions& options,
+    const std::function<::google::protobuf::Message*(int index)>& message_at,
+    std::vector<absl::Status>* statuses) {
+  std::vector<absl::Status> own_statuses;
+  if (statuses == nullptr) statuses = &own_statuses;
+  statuses->assign(proto_strings.size(), absl::OkStatus());
+
+  // Every task hydrates a run of strings into its own buffer and writes only
+  // their messages and statuses. Errors are kept per string, so that a task
+  // never fails and every string is parsed.
+  const int num_strings = proto_strings.size();
+  const int strings_per_task = std::max(options.strings_per_task, 1);
+  RETURN_IF_ERROR(gutil::ParallelFor(
+      (num_strings + strings_per_task - 1) / strings_per_task,
+      options.num_threads, [&](int task) {
+        std::string hydrated;
+        const int end = std::min(num_strings, (task + 1) * strings_per_task);
+        for (int index = task * strings_per_task; index < end; ++index) {
+          hydrated.clear();
+          AppendHydrated(replacements, proto_strings[index], &hydrated);
+          (*statuses)[index] =
+              gutil::ReadProtoFromString(hydrated, message_at(index));
+        }
+        return absl::OkStatus();
+      }));
+
+  int num_failed = 0;
+  int first_failed = -1;
+  for (int index = 0; index < num_strings; ++index) {
+    if ((*statuses)[index].ok()) continue;
+    if (num_failed++ == 0) first_failed = index;
+  }
+  if (num_failed == 0) return absl::OkStatus();
+  return gutil::StatusBuilder((*statuses)[first_failed]).SetPrepend()
+         << num_failed << " of " << num_strings
+         << " strings failed to hydrate; string " << first_failed << ": ";
+}
+
+std::vector<absl::string_view> SplitP4RuntimeProtoStrings(
+    absl::string_view text) {
+  return gutil::SplitTextProtos(text);
+}
+
+absl::StatusOr<std::vector<absl::string_view>> ReadP4RuntimeProtoStrings(
+    absl::string_view filename, gutil::MappedFile* file) {
+  absl::StatusOr<gutil::MappedFile> mapped_file =
+      gutil::MappedFile::Open(filename);
+  if (!mapped_file.ok()) return mapped_file.status();
+  *file = *std::move(mapped_file);
+  return SplitP4RuntimeProtoStrings(file->contents());
+}
+
+absl::StatusOr<HydrationTemplate> HydrationTemplate::Compile(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::string_view proto_template) {
+  std::string hydrated;
+  hydrated.reserve(proto_template.size());
+  AppendHydrated(replacements, proto_template, &hydrated);
+
+  HydrationTemplate result;
+  std::string literal;
+  for (size_t pos = 0; pos < hydrated.size(); ++pos) {
+    if (hydrated[pos] != '$') {
+      literal.push_back(hydrated[pos]);
+      continue;
+    }
+    if (pos + 1 < hydrated.size() && hydrated[pos + 1] == '$') {
+      literal.push_back('$');
+      ++pos;
+      continue;
+    }
+    size_t end = pos + 1;
+    while (end < hydrated.size() && absl::ascii_isdigit(hydrated[end])) ++end;
+    const absl::string_view digits =
+        absl::string_view(hydrated).substr(pos + 1, end - pos - 1);
+    int index;
+    if (digits.empty() || !absl::SimpleAtoi(digits, &index) ||
+        index >= kMaxPlaceholders) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Invalid placeholder at offset " << pos
+             << " of template: " << proto_template;
+    }
+    result.literals_size_ += literal.size();
+    result.literals_.push_back(std::move(literal));
+    literal.clear();
+    result.placeholders_.push_back(index);
+    result.num_values_ = std::max(result.num_values_, index + 1);
+    pos = end - 1;
+  }
+  result.literals_size_ += literal.size();
+  result.literals_.push_back(std::move(literal));
+  return result;
+}
+
+absl::Status HydrationTemplate::Expand(
+    absl::Span<const absl::string_view> values, std::string* output) const {
+  if (static_cast<int>(values.size()) < num_values_) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "The template takes " << num_values_ << " values, but "
+           << values.size() << " were given.";
+  }
+  size_t size = literals_size_;
+  for (int placeholder : placeholders_) size += values[placeholder].size();
+  output->clear();
+  output->reserve(size);
+  output->append(literals_[0]);
+  for (size_t i = 0; i < placeholders_.size(); ++i) {
+    output->append(values[placeholders_[i]].data(),
+                   values[placeholders_[i]].size());
+    output->append(literals_[i + 1]);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status HydrationTemplate::Fill(
+    absl::Span<const absl::string_view> values,
+    ::google::protobuf::Message* message) const {
+  std::string proto_string;
+  RETURN_IF_ERROR(Expand(values, &proto_string));
+  return gutil::ReadProtoFromString(proto_string, message);
+}
+
+absl::StatusOr<P4RTEntityNameIndex> P4RTEntityNameIndex::Create(
+    const P4Info& p4_info) {
+  P4RTEntityNameIndex index;
+  for (const auto& table : p4_info.tables()) {
+    Entity& entity = index.tables_[table.preamble().id()];
+    RET_CHECK(entity.token.empty())
+        << "Duplicate table id " << table.preamble().id() << ".";
+    entity.token = absl::StrCat("{", table.preamble().name(), "}");
+    for (const auto& match : table.match_fields()) {
+      RET_CHECK(gtl::InsertIfNotPresent(
+          &entity.children, match.id(),
+          absl::StrCat("{", table.preamble().name(), ".", match.name(), "}")))
+          << "Duplicate match field id " << match.id() << " in table "
+          << table.preamble().name() << ".";
+    }
+  }
+
+  for (const auto& reg : p4_info.registers()) {
+    Entity& entity = index.registers_[reg.preamble().id()];
+    RET_CHECK(entity.token.empty())
+        << "Duplicate register id " << reg.preamble().id() << ".";
+    entity.token = absl::StrCat("{", reg.preamble().name(), "}");
+  }
+
+  for (const auto& action : p4_info.actions()) {
+    Entity& entity = index.actions_[action.preamble().id()];
+    RET_CHECK(entity.token.empty())
+        << "Duplicate action id " << action.preamble().id() << ".";
+    entity.token = absl::StrCat("{", action.preamble().name(), "}");
+    for (const auto& param : action.params()) {
+      RET_CHECK(gtl::InsertIfNotPresent(
+          &entity.children, param.id(),
+          absl::StrCat("{", action.preamble().name(), ".", param.name(), "}")))
+          << "Duplicate param id " << param.id() << " in action "
+          << action.preamble().name() << ".";
+    }
+  }
+
+  return index;
+}
+
+namespace {
+
+const std::string* FindToken(
+    const absl::flat_hash_map<uint32_t, std::string>& tokens, uint32_t id) {
+  auto it = tokens.find(id);
+  return it == tokens.end() ? nullptr : &it->second;
+}
+
+}  // namespace
+
+const std::string* P4RTEntityNameIndex::TableToken(uint32_t table_id) const {
+  auto it = tables_.find(table_id);
+  return it == tables_.end() ? nullptr : &it->second.token;
+}
+
+const std::string* P4RTEntityNameIndex::MatchFieldToken(
+    uint32_t table_id, uint32_t field_id) const {
+  auto it = tables_.find(table_id);
+  return it == tables_.end() ? nullptr
+                             : FindToken(it->second.children, field_id);
+}
+
+const std::string* P4RTEntityNameIndex::ActionToken(uint32_t action_id) const {
+  auto it = actions_.find(action_id);
+  return it == actions_.end() ? nullptr : &it->second.token;
+}
+
+const std::string* P4RTEntityNameIndex::ParamToken(uint32_t action_id,
+                                                   uint32_t param_id) const {
+  auto it = actions_.find(action_id);
+  return it == actions_.end() ? nullptr
+                              : FindToken(it->second.children, param_id);
+}
+
+const std::string* P4RTEntityNameIndex::RegisterToken(
+    uint32_t register_id) const {
+  auto it = registers_.find(register_id);
+  return it == registers_.end() ? nullptr : &it->second.token;
+}
+
+namespace {
+
+// The id fields that are dehydrated.
+enum class IdField { kNone, kTable, kMatchField, kAction, kParam, kRegister };
+
+IdField GetIdField(absl::string_view field_name) {
+  if (field_name == "table_id") return IdField::kTable;
+  if (field_name == "field_id") return IdField::kMatchField;
+  if (field_name == "action_id") return IdField::kAction;
+  if (field_name == "param_id") return IdField::kParam;
+  if (field_name == "register_id") return IdField::kRegister;
+  return IdField::kNone;
+}
+
+// Resolves ids to tokens, tracking the table and action that match field and
+// param ids belong to.
+class DehydrationContext {
+ public:
+  explicit DehydrationContext(const P4RTEntityNameIndex& index)
+      : index_(index) {}
+
+  // Returns the token of the id, or nullptr if it is unknown.
+  const std::string* Resolve(IdField field, uint32_t id) {
+    switch (field) {
+      case IdField::kTable:
+        table_id_ = id;
+        return index_.TableToken(id);
+      case IdField::kMatchField:
+        return index_.MatchFieldToken(table_id_, id);
+      case IdField::kAction:
+        action_id_ = id;
+        return index_.ActionToken(id);
+      case IdField::kParam:
+        return index_.ParamToken(action_id_, id);
+      case IdField::kRegister:
+        return index_.RegisterToken(id);
+      case IdField::kNone:
+        break;
+    }
+    return nullptr;
+  }
+
+  void Reset() {
+    table_id_ = 0;
+    action_id_ = 0;
+  }
+
+ private:
+  const P4RTEntityNameIndex& index_;
+  uint32_t table_id_ = 0;
+  uint32_t action_id_ = 0;
+};
+
+bool IsIdentifierChar(char c) { return absl::ascii_isalnum(c) || c == '_'; }
+
+// Returns the position after the quoted string that starts at `pos`.
+size_t SkipQuoted(absl::string_view text, size_t pos) {
+  const char quote = text[pos];
+  for (++pos; pos < text.size(); ++pos) {
+    if (text[pos] == '\\') {
+      ++pos;
+    } else if (text[pos] == quote) {
+      return pos + 1;
+    }
+  }
+  return text.size();
+}
+
+// Appends `text` to `output`, with every known id replaced by its token. The
+// text is scanned once; strings and comments are skipped.
+void AppendDehydrated(const P4RTEntityNameIndex& index, absl::string_view text,
+                      std::string* output) {
+  DehydrationContext context(index);
+  size_t literal_start = 0;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    const char c = text[pos];
+    if (c == '"' || c == '\'') {
+      pos = SkipQuoted(text, pos);
+      continue;
+    }
+    if (c == '#') {
+      pos = std::min(text.find('\n', pos), text.size());
+      continue;
+    }
+    if (!IsIdentifierChar(c)) {
+      ++pos;
+      continue;
+    }
+    size_t end = pos + 1;
+    while (end < text.size() && IsIdentifierChar(text[end])) ++end;
+    const IdField field = GetIdField(text.substr(pos, end - pos));
+    pos = end;
+    if (field == IdField::kNone) continue;
+
+    // Find the value after the colon.
+    while (pos < text.size() && absl::ascii_isblank(text[pos])) ++pos;
+    if (pos == text.size() || text[pos] != ':') continue;
+    ++pos;
+    while (pos < text.size() && absl::ascii_isblank(text[pos])) ++pos;
+    const size_t value_start = pos;
+    while (pos < text.size() && absl::ascii_isdigit(text[pos])) ++pos;
+    uint32_t id;
+    if (!absl::SimpleAtoi(text.substr(value_start, pos - value_start), &id)) {
+      continue;
+    }
+
+    const std::string* token = context.Resolve(field, id);
+    if (token != nullptr) {
+      output->append(text.data() + literal_start, value_start - literal_start);
+      output->append(*token);
+      literal_start = pos;
+    }
+  }
+  output->append(text.data() + literal_start, text.size() - literal_start);
+}
+
+// Prints the value of an id field as its token.
+class IdTokenPrinter : public TextFormat::FastFieldValuePrinter {
+ public:
+  IdTokenPrinter(IdField field, DehydrationContext* context)
+      : field_(field), context_(context) {}
+
+  void PrintUInt32(uint32_t value,
+                   TextFormat::BaseTextGenerator* generator) const override {
+    const std::string* token = context_->Resolve(field_, value);
+    if (token == nullptr) {
+      FastFieldValuePrinter::PrintUInt32(value, generator);
+    } else {
+      generator->PrintString(*token);
+    }
+  }
+
+ private:
+  const IdField field_;
+  DehydrationContext* const context_;
+};
+
+// Prints messages with their ids dehydrated in a single pass. The printer
+// visits the fields in order of their numbers, so the table and action ids
+// come before the match field and param ids they give the context for.
+class DehydratingPrinter {
+ public:
+  explicit DehydratingPrinter(const P4RTEntityNameIndex& index)
+      : context_(index) {
+    Register<::p4::v1::TableEntry>("table_id", IdField::kTable);
+    Register<::p4::v1::FieldMatch>("field_id", IdField::kMatchField);
+    Register<::p4::v1::Action>("action_id", IdField::kAction);
+    Register<::p4::v1::Action::Param>("param_id", IdField::kParam);
+    Register<::p4::v1::RegisterEntry>("register_id", IdField::kRegister);
+  }
+
+  void Append(const ::google::protobuf::Message& message,
+              std::string* output) {
+    context_.Reset();
+    // Printing straight into `output` would make the stream grow it to its
+    // capacity on every message.
+    printer_.PrintToString(message, &printed_);
+    output->append(printed_);
+  }
+
+ private:
+  template <typename T>
+  void Register(absl::string_view field_name, IdField field) {
+    // The printer takes ownership of the field value printer.
+    printer_.RegisterFieldValuePrinter(
+        T::descriptor()->FindFieldByName(std::string(field_name)),
+        new IdTokenPrinter(field, &context_));
+  }
+
+  DehydrationContext context_;
+  TextFormat::Printer printer_;
+  std::string printed_;
+};
+
+}  // namespace
+
+absl::Status DehydrateP4RuntimeProtoString(const P4RTEntityNameIndex& index,
+                                           std::string* proto_string) {
+  RET_CHECK(proto_string);
+  std::string dehydrated;
+  dehydrated.reserve(proto_string->size() * 2);
+  AppendDehydrated(index, *proto_string, &dehydrated);
+  proto_string->swap(dehydrated);
+  return absl::OkStatus();
+}
+
+absl::Status DehydrateP4RuntimeProtoString(const P4Info& p4_info,
+                                           std::string* proto_string) {
+  ASSIGN_OR_RETURN(P4RTEntityNameIndex index,
+                   P4RTEntityNameIndex::Create(p4_info));
+  return DehydrateP4RuntimeProtoString(index, proto_string);
+}
+
+void AppendDehydratedP4RuntimeProto(const P4RTEntityNameIndex& index,
+                                    const ::google::protobuf::Message& message,
+                                    std::string* output) {
+  DehydratingPrinter(index).Append(message, output);
+}
+
+void AppendDehydratedP4RuntimeProtos(const P4RTEntityNameIndex& index,
+                                     const ::p4::v1::ReadResponse& response,
+                                     std::string* output) {
+  DehydratingPrinter printer(index);
+  for (const auto& entity : response.entities()) {
+    printer.Append(entity, output);
+    output->push_back('\n');
+  }
+}
+
+void AppendDehydratedP4RuntimeProtos(const P4RTEntityNameIndex& index,
+                                     absl::Span<const TableEntry> entries,
+                                     std::string* output) {
+  DehydratingPrinter printer(index);
+  for (const TableEntry& entry : entries) {
+    printer.Append(entry, output);
+    output->push_back('\n');
+  }
+}
+
 }  // namespace p4runtime_cpp
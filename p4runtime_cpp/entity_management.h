@@ -5,13 +5,20 @@
 #ifndef P4RUNTIME_CPP_ENTITY_MANAGEMENT_H_
 #define P4RUNTIME_CPP_ENTITY_MANAGEMENT_H_
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <vector>
 
 #include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "glog/logging.h"
+#include "gutil/proto.h"
 
 namespace p4runtime_cpp {
 
@@ -23,23 +30,126 @@ absl::Status BuildP4RTEntityIdReplacementMap(
     absl::flat_hash_map<std::string, std::string>* replacements);
 
 // Replace the P4RT entity names with their numeric IDs in the given
-// pseudo-protobuf string and parse as P4RT proto object.
+// pseudo-protobuf string and parse as P4RT proto object. The string is scanned
+// once, and every `{name}` token is resolved with a single lookup; tokens that
+// are not in the map are left as they are.
 absl::Status HydrateP4RuntimeProtoFromString(
     const absl::flat_hash_map<std::string, std::string>& replacements,
-    std::string proto_string, ::google::protobuf::Message* message);
+    absl::string_view proto_string, ::google::protobuf::Message* message);
 
 // One-shot version of HydrateP4RuntimeProtoFromString that also builds the
 // mapping. Consider using BuildP4RTEntityIdReplacementMap if you want to
 // hydrate more than one entry or require faster processing.
 absl::Status HydrateP4RuntimeProtoFromString(
-    const ::p4::config::v1::P4Info& p4_info, std::string proto_string,
+    const ::p4::config::v1::P4Info& p4_info, absl::string_view proto_string,
     ::google::protobuf::Message* message);
 
+// Options for hydrating many pseudo-protobuf strings in parallel.
+struct ParallelHydrationOptions {
+  // The number of threads that hydrate and parse, including the caller's.
+  int num_threads = 4;
+  // The number of strings that a thread takes at a time.
+  int strings_per_task = 64;
+};
+
+// Hydrate and parse every pseudo-protobuf string into the message at the same
+// index, in parallel. The messages are owned by the caller and returned by
+// `message_at`. The status of every string is stored in `statuses`, unless it
+// is null. Returns an error describing the first failed string, if any; all
+// other strings are still parsed.
+absl::Status HydrateP4RuntimeProtosFromStrings(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::Span<const absl::string_view> proto_strings,
+    const ParallelHydrationOptions& options,
+    const std::function<::google::protobuf::Message*(int index)>& message_at,
+    std::vector<absl::Status>* statuses);
+
+// Version of HydrateP4RuntimeProtosFromStrings that resizes `messages` to one
+// message per string, in input order.
+template <typename T>
+absl::Status HydrateP4RuntimeProtosFromStrings(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::Span<const absl::string_view> proto_strings,
+    const ParallelHydrationOptions& options, std::vector<T>* messages,
+    std::vector<absl::Status>* statuses) {
+  messages->clear();
+  messages->resize(proto_strings.size());
+  return HydrateP4RuntimeProtosFromStrings(
+      replacements, proto_strings, options,
+      [messages](int index) { return &(*messages)[index]; }, statuses);
+}
+
+// Split text into the pseudo-protobuf strings it contains, which are separated
+// by blank lines, as written by AppendDehydratedP4RuntimeProtos. Strings that
+// consist only of whitespace and comments are dropped.
+std::vector<absl::string_view> SplitP4RuntimeProtoStrings(
+    absl::string_view text);
+
+// Memory-map a file of pseudo-protobuf strings that are separated by blank
+// lines into `file`, and return the strings, which point into `file`.
+absl::StatusOr<std::vector<absl::string_view>> ReadP4RuntimeProtoStrings(
+    absl::string_view filename, gutil::MappedFile* file);
+
+// Version of HydrateP4RuntimeProtosFromStrings for a file of pseudo-protobuf
+// strings that are separated by blank lines.
+template <typename T>
+absl::Status HydrateP4RuntimeProtosFromFile(
+    const absl::flat_hash_map<std::string, std::string>& replacements,
+    absl::string_view filename, const ParallelHydrationOptions& options,
+    std::vector<T>* messages, std::vector<absl::Status>* statuses) {
+  gutil::MappedFile file;
+  absl::StatusOr<std::vector<absl::string_view>> proto_strings =
+      ReadP4RuntimeProtoStrings(filename, &file);
+  if (!proto_strings.ok()) return proto_strings.status();
+  return HydrateP4RuntimeProtosFromStrings(replacements, *proto_strings,
+                                           options, messages, statuses);
+}
+
+// A pseudo-protobuf string whose P4RT entity names have been replaced once, and
+// which is then filled in repeatedly with per-entry values. Values go into the
+// positional placeholders `$0`, `$1`, ... up to `$65535`; `$$` stands for a
+// literal `$`. Values are inserted verbatim, so string values must be quoted by
+// the template:
+//
+//   ASSIGN_OR_RETURN(auto route, HydrationTemplate::Compile(replacements, R"(
+//       table_id: {ipv4_table}
+//       match { field_id: {ipv4_table.ipv4_dst}
+//               lpm { value: "$0" prefix_len: $1 } })"));
+//   RETURN_IF_ERROR(route.Fill({ip, "24"}, &table_entry));
+class HydrationTemplate {
+ public:
+  static absl::StatusOr<HydrationTemplate> Compile(
+      const absl::flat_hash_map<std::string, std::string>& replacements,
+      absl::string_view proto_template);
+
+  // Return the number of values the template takes, i.e. one more than the
+  // highest placeholder.
+  int NumValues() const { return num_values_; }
+
+  // Write the template with the given values into `output`, replacing its
+  // contents; reuse `output` to avoid reallocating it.
+  absl::Status Expand(absl::Span<const absl::string_view> values,
+                      std::string* output) const;
+  // Fill the template with the given values and parse it into `message`.
+  absl::Status Fill(absl::Span<const absl::string_view> values,
+                    ::google::protobuf::Message* message) const;
+
+ private:
+  HydrationTemplate() = default;
+
+  // The text before each placeholder, followed by the text after the last
+  // one; `literals_` has one element more than `placeholders_`.
+  std::vector<std::string> literals_;
+  std::vector<int> placeholders_;
+  size_t literals_size_ = 0;
+  int num_values_ = 0;
+};
+
 // For testing only.
 template <typename T>
 T HydrateP4RuntimeProtoFromStringOrDie(
     const absl::flat_hash_map<std::string, std::string>& replacements,
-    std::string proto_string) {
+    absl::string_view proto_string) {
   T message;
   // We don't want to expose the CHECK_OK macro to users of this file.
   CHECK_EQ(absl::OkStatus(), HydrateP4RuntimeProtoFromString(
@@ -50,7 +160,7 @@ T HydrateP4RuntimeProtoFromStringOrDie(
 // For testing only.
 template <typename T>
 T HydrateP4RuntimeProtoFromStringOrDie(const ::p4::config::v1::P4Info& p4_info,
-                                       std::string proto_string) {
+                                       absl::string_view proto_string) {
   absl::flat_hash_map<std::string, std::string> replacements;
   CHECK_EQ(absl::OkStatus(),
            BuildP4RTEntityIdReplacementMap(p4_info, &replacements));
@@ -60,10 +170,65 @@ T HydrateP4RuntimeProtoFromStringOrDie(const ::p4::config::v1::P4Info& p4_info,
   return message;
 }
 
-// TODO(max): implement
+// The reverse of the replacement map: resolves the ids of tables, match fields,
+// actions, action parameters and registers to the `{name}` tokens of
+// HydrateP4RuntimeProtoFromString. Build it once per P4Info.
+class P4RTEntityNameIndex {
+ public:
+  static absl::StatusOr<P4RTEntityNameIndex> Create(
+      const ::p4::config::v1::P4Info& p4_info);
+
+  // Return the token of the entity, or nullptr if the id is unknown.
+  const std::string* TableToken(uint32_t table_id) const;
+  const std::string* MatchFieldToken(uint32_t table_id,
+                                     uint32_t field_id) const;
+  const std::string* ActionToken(uint32_t action_id) const;
+  const std::string* ParamToken(uint32_t action_id, uint32_t param_id) const;
+  const std::string* RegisterToken(uint32_t register_id) const;
+
+ private:
+  struct Entity {
+    std::string token;
+    // The tokens of match fields or action parameters.
+    absl::flat_hash_map<uint32_t, std::string> children;
+  };
+
+  P4RTEntityNameIndex() = default;
+
+  absl::flat_hash_map<uint32_t, Entity> tables_;
+  absl::flat_hash_map<uint32_t, Entity> actions_;
+  absl::flat_hash_map<uint32_t, Entity> registers_;
+};
+
+// Replace the numeric ids in the given P4RT text-format string with their
+// `{name}` tokens, so that HydrateP4RuntimeProtoFromString restores the
+// original. Match field and parameter ids are resolved in the context of the
+// table_id and action_id that precede them, as in printed protos. The string is
+// scanned once; ids that are not in the index are left as they are.
+absl::Status DehydrateP4RuntimeProtoString(const P4RTEntityNameIndex& index,
+                                           std::string* proto_string);
+
+// One-shot version of DehydrateP4RuntimeProtoString that also builds the
+// index.
 absl::Status DehydrateP4RuntimeProtoString(
     const ::p4::config::v1::P4Info& p4_info, std::string* proto_string);
 
+// Print the message in text format with its ids dehydrated, appending to
+// `output`.
+void AppendDehydratedP4RuntimeProto(const P4RTEntityNameIndex& index,
+                                    const ::google::protobuf::Message& message,
+                                    std::string* output);
+
+// Batch versions of AppendDehydratedP4RuntimeProto for dumping switch state.
+// Every entity or entry is appended to `output`, followed by a blank line.
+// Reserve or reuse `output` to avoid reallocating it.
+void AppendDehydratedP4RuntimeProtos(const P4RTEntityNameIndex& index,
+                                     const ::p4::v1::ReadResponse& response,
+                                     std::string* output);
+void AppendDehydratedP4RuntimeProtos(
+    const P4RTEntityNameIndex& index,
+    absl::Span<const ::p4::v1::TableEntry> entries, std::string* output);
+
 }  // namespace p4runtime_cpp
 
 #endif  // P4RUNTIME_CPP_ENTITY_MANAGEMENT_H_
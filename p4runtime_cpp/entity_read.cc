@@ -0,0 +1,136 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/entity_read.h"
+
+#include <utility>
+
+#include "gutil/status.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::Entity;
+
+EntityReadBuilder& EntityReadBuilder::AddTable(uint32_t table_id,
+                                               bool include_counter_data,
+                                               bool include_meter_config) {
+  p4::v1::TableEntry* table_entry =
+      entities_.emplace_back().mutable_table_entry();
+  table_entry->set_table_id(table_id);
+  if (include_counter_data) table_entry->mutable_counter_data();
+  if (include_meter_config) table_entry->mutable_meter_config();
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddCounter(uint32_t counter_id) {
+  entities_.emplace_back().mutable_counter_entry()->set_counter_id(counter_id);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddCounter(uint32_t counter_id,
+                                                 int64_t index) {
+  p4::v1::CounterEntry* counter_entry =
+      entities_.emplace_back().mutable_counter_entry();
+  counter_entry->set_counter_id(counter_id);
+  counter_entry->mutable_index()->set_index(index);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddMeter(uint32_t meter_id) {
+  entities_.emplace_back().mutable_meter_entry()->set_meter_id(meter_id);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddMeter(uint32_t meter_id,
+                                               int64_t index) {
+  p4::v1::MeterEntry* meter_entry =
+      entities_.emplace_back().mutable_meter_entry();
+  meter_entry->set_meter_id(meter_id);
+  meter_entry->mutable_index()->set_index(index);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddRegister(uint32_t register_id) {
+  entities_.emplace_back().mutable_register_entry()->set_register_id(
+      register_id);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddRegister(uint32_t register_id,
+                                                  int64_t index) {
+  p4::v1::RegisterEntry* register_entry =
+      entities_.emplace_back().mutable_register_entry();
+  register_entry->set_register_id(register_id);
+  register_entry->mutable_index()->set_index(index);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddActionProfileMembers(
+    uint32_t action_profile_id) {
+  entities_.emplace_back()
+      .mutable_action_profile_member()
+      ->set_action_profile_id(action_profile_id);
+  return *this;
+}
+
+EntityReadBuilder& EntityReadBuilder::AddActionProfileGroups(
+    uint32_t action_profile_id) {
+  entities_.emplace_back()
+      .mutable_action_profile_group()
+      ->set_action_profile_id(action_profile_id);
+  return *this;
+}
+
+p4::v1::ReadRequest EntityReadBuilder::Build(uint32_t device_id) const {
+  p4::v1::ReadRequest read_request;
+  read_request.set_device_id(device_id);
+  read_request.mutable_entities()->Reserve(entities_.size());
+  for (const Entity& entity : entities_) {
+    *read_request.add_entities() = entity;
+  }
+  return read_request;
+}
+
+absl::StatusOr<EntityReadResult> EntityReadBuilder::Read(
+    P4RuntimeSession* session) const {
+  EntityReadResult result;
+  RETURN_IF_ERROR(SendReadRequest(
+      session, Build(session->DeviceId()),
+      [&](Entity* entity) -> absl::Status {
+        switch (entity->entity_case()) {
+          case Entity::kTableEntry:
+            result.table_entries.push_back(
+                std::move(*entity->mutable_table_entry()));
+            break;
+          case Entity::kCounterEntry:
+            result.counter_entries.push_back(
+                std::move(*entity->mutable_counter_entry()));
+            break;
+          case Entity::kMeterEntry:
+            result.meter_entries.push_back(
+                std::move(*entity->mutable_meter_entry()));
+            break;
+          case Entity::kRegisterEntry:
+            result.register_entries.push_back(
+                std::move(*entity->mutable_register_entry()));
+            break;
+          case Entity::kActionProfileMember:
+            result.action_profile_members.push_back(
+                std::move(*entity->mutable_action_profile_member()));
+            break;
+          case Entity::kActionProfileGroup:
+            result.action_profile_groups.push_back(
+                std::move(*entity->mutable_action_profile_group()));
+            break;
+          default:
+            return gutil::InternalErrorBuilder()
+                   << "Unexpected entity in the read response: "
+                   << entity->ShortDebugString();
+        }
+        return absl::OkStatus();
+      }));
+  // Move is needed to make the older compiler happy.
+  return std::move(result);
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,71 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_ENTITY_READ_H_
+#define P4RUNTIME_CPP_ENTITY_READ_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/statusor.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+namespace p4runtime_cpp {
+
+// The entities returned by a read, split by kind, each in the order they were
+// received.
+struct EntityReadResult {
+  std::vector<p4::v1::TableEntry> table_entries;
+  std::vector<p4::v1::CounterEntry> counter_entries;
+  std::vector<p4::v1::MeterEntry> meter_entries;
+  std::vector<p4::v1::RegisterEntry> register_entries;
+  std::vector<p4::v1::ActionProfileMember> action_profile_members;
+  std::vector<p4::v1::ActionProfileGroup> action_profile_groups;
+};
+
+// Builds a single read request out of any number of entity filters, so that
+// reading many counters, meters or tables costs one round trip instead of one
+// per entity. As in P4Runtime, an id of 0 reads all entities of that kind.
+//
+//   ASSIGN_OR_RETURN(EntityReadResult result,
+//                    EntityReadBuilder()
+//                        .AddCounter(kIngressCounterId)
+//                        .AddCounter(kEgressCounterId, /*index=*/7)
+//                        .AddTable(kAclTableId, /*include_counter_data=*/true)
+//                        .Read(session));
+class EntityReadBuilder {
+ public:
+  // Read the entries of the table.
+  EntityReadBuilder& AddTable(uint32_t table_id,
+                              bool include_counter_data = false,
+                              bool include_meter_config = false);
+  // Read all entries, or the entry at the given index, of an indirect counter.
+  EntityReadBuilder& AddCounter(uint32_t counter_id);
+  EntityReadBuilder& AddCounter(uint32_t counter_id, int64_t index);
+  // Read all entries, or the entry at the given index, of an indirect meter.
+  EntityReadBuilder& AddMeter(uint32_t meter_id);
+  EntityReadBuilder& AddMeter(uint32_t meter_id, int64_t index);
+  // Read all entries, or the entry at the given index, of a register.
+  EntityReadBuilder& AddRegister(uint32_t register_id);
+  EntityReadBuilder& AddRegister(uint32_t register_id, int64_t index);
+  // Read the members or the groups of an action profile.
+  EntityReadBuilder& AddActionProfileMembers(uint32_t action_profile_id);
+  EntityReadBuilder& AddActionProfileGroups(uint32_t action_profile_id);
+
+  // Return the number of entity filters added so far.
+  int NumFilters() const { return entities_.size(); }
+
+  // Build the read request for the given device.
+  p4::v1::ReadRequest Build(uint32_t device_id) const;
+
+  // Send the read request on the session and split the response by kind.
+  absl::StatusOr<EntityReadResult> Read(P4RuntimeSession* session) const;
+
+ private:
+  std::vector<p4::v1::Entity> entities_;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_ENTITY_READ_H_
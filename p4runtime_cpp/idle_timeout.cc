@@ -0,0 +1,158 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/idle_timeout.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/memory/memory.h"
+#include "absl/synchronization/mutex.h"
+#include "glog/logging.h"
+#include "gutil/status.h"
+#include "p4runtime_cpp/table_entry_key.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::StreamMessageResponse;
+using ::p4::v1::TableEntry;
+using ::p4::v1::Update;
+
+struct IdleTimeoutAger::PendingEntries {
+  explicit PendingEntries(int max_entries) : max_entries(max_entries) {}
+
+  bool IsFullOrShutdown() const ABSL_SHARED_LOCKS_REQUIRED(mutex) {
+    return shutdown || static_cast<int>(keys.size()) >= max_entries;
+  }
+  bool HasEntriesOrShutdown() const ABSL_SHARED_LOCKS_REQUIRED(mutex) {
+    return shutdown || !keys.empty();
+  }
+
+  const int max_entries;
+
+  // Serializes flushes.
+  absl::Mutex flush_mutex ABSL_ACQUIRED_BEFORE(mutex);
+  absl::Mutex mutex;
+  absl::flat_hash_set<TableEntryKey, TableEntryKeyHash, TableEntryKeyEq> keys
+      ABSL_GUARDED_BY(mutex);
+  // When the oldest pending entry was notified.
+  absl::Time oldest ABSL_GUARDED_BY(mutex);
+  bool shutdown ABSL_GUARDED_BY(mutex) = false;
+};
+
+IdleTimeoutAger::IdleTimeoutAger(P4RuntimeSession* session, Options options)
+    : session_(session),
+      options_(std::move(options)),
+      pending_(
+          std::make_shared<PendingEntries>(options_.max_pending_entries)) {}
+
+absl::StatusOr<std::unique_ptr<IdleTimeoutAger>> IdleTimeoutAger::Create(
+    P4RuntimeSession* session, Options options) {
+  // Using `new` to access a private constructor.
+  std::unique_ptr<IdleTimeoutAger> ager =
+      absl::WrapUnique(new IdleTimeoutAger(session, std::move(options)));
+  RETURN_IF_ERROR(session->RegisterStreamMessageHandler(
+      StreamMessageResponse::kIdleTimeoutNotification,
+      [pending = ager->pending_](const StreamMessageResponse& message) {
+        absl::MutexLock lock(&pending->mutex);
+        if (pending->shutdown) return;
+        for (const TableEntry& entry :
+             message.idle_timeout_notification().table_entry()) {
+          if (pending->keys.empty()) pending->oldest = absl::Now();
+          pending->keys.emplace(entry);
+        }
+      }));
+  ager->flush_thread_ = std::thread([ager = ager.get()]() {
+    ager->FlushLoop();
+  });
+  // Move is needed to make the older compiler happy.
+  return std::move(ager);
+}
+
+IdleTimeoutAger::~IdleTimeoutAger() {
+  {
+    absl::MutexLock lock(&pending_->mutex);
+    pending_->shutdown = true;
+  }
+  if (flush_thread_.joinable()) flush_thread_.join();
+  absl::Status status = Flush();
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to delete idle entries: " << status;
+  }
+}
+
+absl::Status IdleTimeoutAger::Flush() {
+  absl::MutexLock flush_lock(&pending_->flush_mutex);
+  std::vector<TableEntry> entries;
+  {
+    absl::MutexLock lock(&pending_->mutex);
+    entries.reserve(pending_->keys.size());
+    for (const TableEntryKey& key : pending_->keys) {
+      entries.push_back(key.Entry());
+    }
+    pending_->keys.clear();
+  }
+  if (options_.veto) {
+    auto kept = std::remove_if(entries.begin(), entries.end(),
+                               options_.veto);
+    vetoed_entries_.fetch_add(entries.end() - kept,
+                              std::memory_order_relaxed);
+    entries.erase(kept, entries.end());
+  }
+  std::vector<Update> updates(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    updates[i].set_type(Update::DELETE);
+    *updates[i].mutable_entity()->mutable_table_entry() =
+        std::move(entries[i]);
+  }
+  std::vector<absl::Status> statuses;
+  // The per-update statuses tell what happened; the overall status does not.
+  SendBatchedWriteRequests(session_, updates, options_.limits, &statuses)
+      .IgnoreError();
+
+  // Entries that are already gone, e.g. deleted by someone else, fail with
+  // NOT_FOUND. Other failures are retried with the next flush, since the switch
+  // notifies every entry only once.
+  int64_t deleted = 0;
+  int failed = 0;
+  absl::Status first_error;
+  {
+    absl::MutexLock lock(&pending_->mutex);
+    for (size_t i = 0; i < updates.size(); ++i) {
+      const absl::Status& status = statuses[i];
+      if (status.ok()) {
+        ++deleted;
+      } else if (!absl::IsNotFound(status)) {
+        if (failed++ == 0) first_error = status;
+        if (pending_->keys.empty()) pending_->oldest = absl::Now();
+        pending_->keys.emplace(updates[i].entity().table_entry());
+      }
+    }
+  }
+  deleted_entries_.fetch_add(deleted, std::memory_order_relaxed);
+  if (failed == 0) return absl::OkStatus();
+  return gutil::StatusBuilder(first_error).SetPrepend()
+         << "Failed to delete " << failed << " of " << updates.size()
+         << " idle entries, which are retried; first error: ";
+}
+
+void IdleTimeoutAger::FlushLoop() {
+  while (true) {
+    {
+      absl::MutexLock lock(&pending_->mutex);
+      pending_->mutex.Await(absl::Condition(
+          pending_.get(), &PendingEntries::HasEntriesOrShutdown));
+      if (pending_->shutdown) return;
+      pending_->mutex.AwaitWithDeadline(
+          absl::Condition(pending_.get(), &PendingEntries::IsFullOrShutdown),
+          pending_->oldest + options_.max_delay);
+      if (pending_->shutdown) return;
+    }
+    absl::Status status = Flush();
+    if (!status.ok()) LOG(WARNING) << status;
+  }
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,83 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_IDLE_TIMEOUT_H_
+#define P4RUNTIME_CPP_IDLE_TIMEOUT_H_
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/time/time.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+namespace p4runtime_cpp {
+
+// Ages out table entries in response to the idle-timeout notifications of the
+// switch. Notified entries are de-duplicated by key and deleted in batches,
+// once enough of them are pending or once the oldest one has waited long
+// enough. Only one ager can be attached to a session, as it consumes all of
+// its idle-timeout notifications.
+class IdleTimeoutAger {
+ public:
+  struct Options {
+    // Delete once this many distinct entries are pending.
+    int max_pending_entries = 1000;
+    // Delete once the oldest pending entry has waited this long.
+    absl::Duration max_delay = absl::Milliseconds(100);
+    // Limits for the write requests that delete the entries.
+    WriteBatchLimits limits;
+    // If set, called for every entry about to be deleted, with the key fields
+    // of the entry only. Returning true keeps the entry.
+    std::function<bool(const p4::v1::TableEntry& entry)> veto;
+  };
+
+  // Starts consuming the idle-timeout notifications of the session, which must
+  // outlive the ager.
+  static absl::StatusOr<std::unique_ptr<IdleTimeoutAger>> Create(
+      P4RuntimeSession* session, Options options);
+  // Deletes all pending entries and stops consuming notifications.
+  ~IdleTimeoutAger();
+
+  // Disable copy semantics.
+  IdleTimeoutAger(const IdleTimeoutAger&) = delete;
+  IdleTimeoutAger& operator=(const IdleTimeoutAger&) = delete;
+
+  // Deletes all pending entries now. Entries that are already gone are
+  // dropped; entries that fail to be deleted otherwise stay pending.
+  absl::Status Flush();
+
+  // Returns the number of entries that have been deleted by the ager.
+  int64_t DeletedEntries() const {
+    return deleted_entries_.load(std::memory_order_relaxed);
+  }
+  // Returns the number of entries that have been kept by the veto.
+  int64_t VetoedEntries() const {
+    return vetoed_entries_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // The entries that are waiting to be deleted. Shared with the notification
+  // handler of the session, which outlives the ager.
+  struct PendingEntries;
+
+  IdleTimeoutAger(P4RuntimeSession* session, Options options);
+
+  // Runs the batched deletion until the ager is destroyed.
+  void FlushLoop();
+
+  P4RuntimeSession* session_;
+  const Options options_;
+  std::shared_ptr<PendingEntries> pending_;
+  std::atomic<int64_t> deleted_entries_{0};
+  std::atomic<int64_t> vetoed_entries_{0};
+  std::thread flush_thread_;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_IDLE_TIMEOUT_H_
@@ -0,0 +1,358 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/p4info_bindings.h"
+
+#include <utility>
+
+#include "gutil/status.h"
+#include "p4runtime_cpp/bytestring.h"
+
+namespace p4runtime_cpp {
+namespace bindings {
+
+using ::p4::v1::FieldMatch;
+using ::p4::v1::TableEntry;
+
+namespace {
+
+// Returns a mask of the lowest `bits` bits.
+uint64_t LowBits(int bits) {
+  return bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << bits) - 1;
+}
+
+absl::Status Encode(uint64_t value, int bitwidth, absl::string_view name,
+                    std::string* bytes) {
+  if (bitwidth == 0) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "'" << name << "' is a translated field and needs its value "
+           << "as bytes.";
+  }
+  if (!EncodeBytestring(value, bitwidth, bytes)) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Value " << value << " of '" << name << "' does not fit into "
+           << bitwidth << " bits.";
+  }
+  return absl::OkStatus();
+}
+
+// Bitwidth 0 stands for translated fields, whose bytes are kept as they are.
+absl::Status Encode(absl::string_view value, int bitwidth,
+                    absl::string_view name, std::string* bytes) {
+  if (bitwidth == 0) {
+    bytes->assign(value.data(), value.size());
+    return absl::OkStatus();
+  }
+  if (!CanonicalizeBytestring(value, bitwidth, bytes)) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Value of '" << name << "' does not fit into " << bitwidth
+           << " bits.";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Decode(absl::string_view bytes, int bitwidth,
+                    absl::string_view name, uint64_t* value) {
+  if (!DecodeBytestring(bytes, bitwidth, value)) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Value of '" << name << "' does not fit into " << bitwidth
+           << " bits.";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status Decode(absl::string_view bytes, int bitwidth,
+                    absl::string_view name, std::string* value) {
+  return Encode(bytes, bitwidth, name, value);
+}
+
+absl::Status CheckPrefixLength(int32_t prefix_len, int bitwidth,
+                               absl::string_view name) {
+  if (prefix_len < 0 || prefix_len > bitwidth) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Invalid prefix length " << prefix_len << " of '" << name
+           << "', which has " << bitwidth << " bits.";
+  }
+  return absl::OkStatus();
+}
+
+absl::Status CheckMatchType(const FieldMatch& match,
+                            FieldMatch::FieldMatchTypeCase type,
+                            absl::string_view type_name,
+                            absl::string_view name) {
+  if (match.field_match_type_case() != type) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Match on '" << name << "' is not a " << type_name
+           << " match.";
+  }
+  return absl::OkStatus();
+}
+
+FieldMatch* AddMatch(uint32_t field_id, TableEntry* entry) {
+  FieldMatch* match = entry->add_match();
+  match->set_field_id(field_id);
+  return match;
+}
+
+}  // namespace
+
+absl::Status AddExactMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name, uint64_t value,
+                           TableEntry* entry) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  *AddMatch(field_id, entry)->mutable_exact()->mutable_value() =
+      std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddExactMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name, absl::string_view value,
+                           TableEntry* entry) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  *AddMatch(field_id, entry)->mutable_exact()->mutable_value() =
+      std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddLpmMatch(uint32_t field_id, int bitwidth,
+                         absl::string_view name,
+                         const LpmMatch<uint64_t>& match, TableEntry* entry) {
+  RETURN_IF_ERROR(CheckPrefixLength(match.prefix_len, bitwidth, name));
+  if (match.prefix_len == 0) return absl::OkStatus();
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(match.value & ~LowBits(bitwidth - match.prefix_len),
+                         bitwidth, name, &bytes));
+  FieldMatch::LPM* lpm = AddMatch(field_id, entry)->mutable_lpm();
+  *lpm->mutable_value() = std::move(bytes);
+  lpm->set_prefix_len(match.prefix_len);
+  return absl::OkStatus();
+}
+
+absl::Status AddLpmMatch(uint32_t field_id, int bitwidth,
+                         absl::string_view name,
+                         const LpmMatch<std::string>& match,
+                         TableEntry* entry) {
+  RETURN_IF_ERROR(CheckPrefixLength(match.prefix_len, bitwidth, name));
+  if (match.prefix_len == 0) return absl::OkStatus();
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(match.value, bitwidth, name, &bytes));
+  ClearBytestringLowBits(bitwidth - match.prefix_len, &bytes);
+  FieldMatch::LPM* lpm = AddMatch(field_id, entry)->mutable_lpm();
+  // Clearing may have produced leading zeros.
+  CanonicalizeBytestring(bytes, bitwidth, lpm->mutable_value());
+  lpm->set_prefix_len(match.prefix_len);
+  return absl::OkStatus();
+}
+
+absl::Status AddTernaryMatch(uint32_t field_id, int bitwidth,
+                             absl::string_view name,
+                             const TernaryMatch<uint64_t>& match,
+                             TableEntry* entry) {
+  if (match.mask == 0) return absl::OkStatus();
+  std::string value_bytes;
+  std::string mask_bytes;
+  RETURN_IF_ERROR(Encode(match.value & match.mask, bitwidth, name,
+                         &value_bytes));
+  RETURN_IF_ERROR(Encode(match.mask, bitwidth, name, &mask_bytes));
+  FieldMatch::Ternary* ternary = AddMatch(field_id, entry)->mutable_ternary();
+  *ternary->mutable_value() = std::move(value_bytes);
+  *ternary->mutable_mask() = std::move(mask_bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddTernaryMatch(uint32_t field_id, int bitwidth,
+                             absl::string_view name,
+                             const TernaryMatch<std::string>& match,
+                             TableEntry* entry) {
+  if (IsZeroBytestring(match.mask)) return absl::OkStatus();
+  std::string value_bytes;
+  std::string mask_bytes;
+  RETURN_IF_ERROR(Encode(match.value, bitwidth, name, &value_bytes));
+  RETURN_IF_ERROR(Encode(match.mask, bitwidth, name, &mask_bytes));
+  MaskBytestring(mask_bytes, &value_bytes);
+  FieldMatch::Ternary* ternary = AddMatch(field_id, entry)->mutable_ternary();
+  // Masking may have produced leading zeros.
+  CanonicalizeBytestring(value_bytes, bitwidth, ternary->mutable_value());
+  *ternary->mutable_mask() = std::move(mask_bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddRangeMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name,
+                           const RangeMatch<uint64_t>& match,
+                           TableEntry* entry) {
+  if (match.low > match.high) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Empty range [" << match.low << ", " << match.high << "] of '"
+           << name << "'.";
+  }
+  // The full range is a don't-care match. It is only representable for
+  // fields of at most 64 bits; translated fields need their bytes anyway.
+  if (bitwidth > 0 && bitwidth <= 64 && match.low == 0 &&
+      match.high == LowBits(bitwidth)) {
+    return absl::OkStatus();
+  }
+  std::string low_bytes;
+  std::string high_bytes;
+  RETURN_IF_ERROR(Encode(match.low, bitwidth, name, &low_bytes));
+  RETURN_IF_ERROR(Encode(match.high, bitwidth, name, &high_bytes));
+  FieldMatch::Range* range = AddMatch(field_id, entry)->mutable_range();
+  *range->mutable_low() = std::move(low_bytes);
+  *range->mutable_high() = std::move(high_bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddRangeMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name,
+                           const RangeMatch<std::string>& match,
+                           TableEntry* entry) {
+  std::string low_bytes;
+  std::string high_bytes;
+  RETURN_IF_ERROR(Encode(match.low, bitwidth, name, &low_bytes));
+  RETURN_IF_ERROR(Encode(match.high, bitwidth, name, &high_bytes));
+  FieldMatch::Range* range = AddMatch(field_id, entry)->mutable_range();
+  *range->mutable_low() = std::move(low_bytes);
+  *range->mutable_high() = std::move(high_bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddOptionalMatch(uint32_t field_id, int bitwidth,
+                              absl::string_view name, uint64_t value,
+                              TableEntry* entry) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  *AddMatch(field_id, entry)->mutable_optional()->mutable_value() =
+      std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddOptionalMatch(uint32_t field_id, int bitwidth,
+                              absl::string_view name, absl::string_view value,
+                              TableEntry* entry) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  *AddMatch(field_id, entry)->mutable_optional()->mutable_value() =
+      std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status ReadExactMatch(const FieldMatch& match, int bitwidth,
+                            absl::string_view name, uint64_t* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kExact, "exact", name));
+  return Decode(match.exact().value(), bitwidth, name, value);
+}
+
+absl::Status ReadExactMatch(const FieldMatch& match, int bitwidth,
+                            absl::string_view name, std::string* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kExact, "exact", name));
+  return Decode(match.exact().value(), bitwidth, name, value);
+}
+
+absl::Status ReadLpmMatch(const FieldMatch& match, int bitwidth,
+                          absl::string_view name, LpmMatch<uint64_t>* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kLpm, "LPM", name));
+  RETURN_IF_ERROR(CheckPrefixLength(match.lpm().prefix_len(), bitwidth, name));
+  value->prefix_len = match.lpm().prefix_len();
+  return Decode(match.lpm().value(), bitwidth, name, &value->value);
+}
+
+absl::Status ReadLpmMatch(const FieldMatch& match, int bitwidth,
+                          absl::string_view name,
+                          LpmMatch<std::string>* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kLpm, "LPM", name));
+  RETURN_IF_ERROR(CheckPrefixLength(match.lpm().prefix_len(), bitwidth, name));
+  value->prefix_len = match.lpm().prefix_len();
+  return Decode(match.lpm().value(), bitwidth, name, &value->value);
+}
+
+absl::Status ReadTernaryMatch(const FieldMatch& match, int bitwidth,
+                              absl::string_view name,
+                              TernaryMatch<uint64_t>* value) {
+  RETURN_IF_ERROR(
+      CheckMatchType(match, FieldMatch::kTernary, "ternary", name));
+  RETURN_IF_ERROR(Decode(match.ternary().value(), bitwidth, name,
+                         &value->value));
+  return Decode(match.ternary().mask(), bitwidth, name, &value->mask);
+}
+
+absl::Status ReadTernaryMatch(const FieldMatch& match, int bitwidth,
+                              absl::string_view name,
+                              TernaryMatch<std::string>* value) {
+  RETURN_IF_ERROR(
+      CheckMatchType(match, FieldMatch::kTernary, "ternary", name));
+  RETURN_IF_ERROR(Decode(match.ternary().value(), bitwidth, name,
+                         &value->value));
+  return Decode(match.ternary().mask(), bitwidth, name, &value->mask);
+}
+
+absl::Status ReadRangeMatch(const FieldMatch& match, int bitwidth,
+                            absl::string_view name,
+                            RangeMatch<uint64_t>* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kRange, "range", name));
+  RETURN_IF_ERROR(Decode(match.range().low(), bitwidth, name, &value->low));
+  return Decode(match.range().high(), bitwidth, name, &value->high);
+}
+
+absl::Status ReadRangeMatch(const FieldMatch& match, int bitwidth,
+                            absl::string_view name,
+                            RangeMatch<std::string>* value) {
+  RETURN_IF_ERROR(CheckMatchType(match, FieldMatch::kRange, "range", name));
+  RETURN_IF_ERROR(Decode(match.range().low(), bitwidth, name, &value->low));
+  return Decode(match.range().high(), bitwidth, name, &value->high);
+}
+
+absl::Status ReadOptionalMatch(const FieldMatch& match, int bitwidth,
+                               absl::string_view name, uint64_t* value) {
+  RETURN_IF_ERROR(
+      CheckMatchType(match, FieldMatch::kOptional, "optional", name));
+  return Decode(match.optional().value(), bitwidth, name, value);
+}
+
+absl::Status ReadOptionalMatch(const FieldMatch& match, int bitwidth,
+                               absl::string_view name, std::string* value) {
+  RETURN_IF_ERROR(
+      CheckMatchType(match, FieldMatch::kOptional, "optional", name));
+  return Decode(match.optional().value(), bitwidth, name, value);
+}
+
+absl::Status AddParam(uint32_t param_id, int bitwidth, absl::string_view name,
+                      uint64_t value, p4::v1::Action* action) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  p4::v1::Action::Param* param = action->add_params();
+  param->set_param_id(param_id);
+  *param->mutable_value() = std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status AddParam(uint32_t param_id, int bitwidth, absl::string_view name,
+                      absl::string_view value, p4::v1::Action* action) {
+  std::string bytes;
+  RETURN_IF_ERROR(Encode(value, bitwidth, name, &bytes));
+  p4::v1::Action::Param* param = action->add_params();
+  param->set_param_id(param_id);
+  *param->mutable_value() = std::move(bytes);
+  return absl::OkStatus();
+}
+
+absl::Status ReadParam(const p4::v1::Action::Param& param, int bitwidth,
+                       absl::string_view name, uint64_t* value) {
+  return Decode(param.value(), bitwidth, name, value);
+}
+
+absl::Status ReadParam(const p4::v1::Action::Param& param, int bitwidth,
+                       absl::string_view name, std::string* value) {
+  return Decode(param.value(), bitwidth, name, value);
+}
+
+absl::Status UnexpectedIdError(absl::string_view kind, uint32_t id,
+                               absl::string_view context) {
+  return gutil::InvalidArgumentErrorBuilder()
+         << "Unexpected " << kind << " id " << id << " in '" << context
+         << "'.";
+}
+
+}  // namespace bindings
+}  // namespace p4runtime_cpp
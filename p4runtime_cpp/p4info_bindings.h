@@ -0,0 +1,134 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_P4INFO_BINDINGS_H_
+#define P4RUNTIME_CPP_P4INFO_BINDINGS_H_
+
+#include <cstdint>
+#include <string>
+
+#include "absl/status/status.h"
+#include "absl/strings/string_view.h"
+#include "p4/v1/p4runtime.pb.h"
+
+// Support code of the bindings generated by cc_p4info_library, which also
+// encodes the matches and params of TableEntryBuilder. Values of fields of at
+// most 64 bits are held as uint64_t; wider and translated fields (bitwidth 0)
+// hold their big-endian bytes as a std::string.
+namespace p4runtime_cpp {
+namespace bindings {
+
+template <typename T>
+struct LpmMatch {
+  T value{};
+  int32_t prefix_len = 0;
+};
+
+template <typename T>
+struct TernaryMatch {
+  T value{};
+  T mask{};
+};
+
+template <typename T>
+struct RangeMatch {
+  T low{};
+  T high{};
+};
+
+// Indirect actions of tables with an action profile.
+struct ActionProfileMemberId {
+  uint32_t id = 0;
+};
+struct ActionProfileGroupId {
+  uint32_t id = 0;
+};
+
+// Add a match on the given field to the entry. Don't-care matches are left
+// out, as required by P4Runtime, and bits outside of the mask or prefix are
+// cleared. `name` is used in error messages.
+absl::Status AddExactMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name, uint64_t value,
+                           p4::v1::TableEntry* entry);
+absl::Status AddExactMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name, absl::string_view value,
+                           p4::v1::TableEntry* entry);
+absl::Status AddLpmMatch(uint32_t field_id, int bitwidth,
+                         absl::string_view name,
+                         const LpmMatch<uint64_t>& match,
+                         p4::v1::TableEntry* entry);
+absl::Status AddLpmMatch(uint32_t field_id, int bitwidth,
+                         absl::string_view name,
+                         const LpmMatch<std::string>& match,
+                         p4::v1::TableEntry* entry);
+absl::Status AddTernaryMatch(uint32_t field_id, int bitwidth,
+                             absl::string_view name,
+                             const TernaryMatch<uint64_t>& match,
+                             p4::v1::TableEntry* entry);
+absl::Status AddTernaryMatch(uint32_t field_id, int bitwidth,
+                             absl::string_view name,
+                             const TernaryMatch<std::string>& match,
+                             p4::v1::TableEntry* entry);
+absl::Status AddRangeMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name,
+                           const RangeMatch<uint64_t>& match,
+                           p4::v1::TableEntry* entry);
+absl::Status AddRangeMatch(uint32_t field_id, int bitwidth,
+                           absl::string_view name,
+                           const RangeMatch<std::string>& match,
+                           p4::v1::TableEntry* entry);
+absl::Status AddOptionalMatch(uint32_t field_id, int bitwidth,
+                              absl::string_view name, uint64_t value,
+                              p4::v1::TableEntry* entry);
+absl::Status AddOptionalMatch(uint32_t field_id, int bitwidth,
+                              absl::string_view name, absl::string_view value,
+                              p4::v1::TableEntry* entry);
+
+// Read the match on a field of the given bitwidth.
+absl::Status ReadExactMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                            absl::string_view name, uint64_t* value);
+absl::Status ReadExactMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                            absl::string_view name, std::string* value);
+absl::Status ReadLpmMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                          absl::string_view name, LpmMatch<uint64_t>* value);
+absl::Status ReadLpmMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                          absl::string_view name,
+                          LpmMatch<std::string>* value);
+absl::Status ReadTernaryMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                              absl::string_view name,
+                              TernaryMatch<uint64_t>* value);
+absl::Status ReadTernaryMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                              absl::string_view name,
+                              TernaryMatch<std::string>* value);
+absl::Status ReadRangeMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                            absl::string_view name,
+                            RangeMatch<uint64_t>* value);
+absl::Status ReadRangeMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                            absl::string_view name,
+                            RangeMatch<std::string>* value);
+absl::Status ReadOptionalMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                               absl::string_view name, uint64_t* value);
+absl::Status ReadOptionalMatch(const p4::v1::FieldMatch& match, int bitwidth,
+                               absl::string_view name, std::string* value);
+
+// Add a param to the action.
+absl::Status AddParam(uint32_t param_id, int bitwidth, absl::string_view name,
+                      uint64_t value, p4::v1::Action* action);
+absl::Status AddParam(uint32_t param_id, int bitwidth, absl::string_view name,
+                      absl::string_view value, p4::v1::Action* action);
+
+// Read the value of a param.
+absl::Status ReadParam(const p4::v1::Action::Param& param, int bitwidth,
+                       absl::string_view name, uint64_t* value);
+absl::Status ReadParam(const p4::v1::Action::Param& param, int bitwidth,
+                       absl::string_view name, std::string* value);
+
+// Returns the error for an id that is not expected in the given context, e.g.
+// an unknown match field id in an entry of a table.
+absl::Status UnexpectedIdError(absl::string_view kind, uint32_t id,
+                               absl::string_view context);
+
+}  // namespace bindings
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_P4INFO_BINDINGS_H_
@@ -0,0 +1,592 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/p4info_codegen.h"
+
+#include <cctype>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "gutil/status.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::config::v1::MatchField;
+using ::p4::config::v1::P4Info;
+using ::p4::config::v1::Preamble;
+using ::p4::config::v1::Table;
+
+namespace {
+
+constexpr absl::string_view kBindings = "::p4runtime_cpp::bindings::";
+
+// C++ keywords, the names of the members that every table struct has, and the
+// names of the parameters and locals of the generated ToProto and FromProto.
+bool IsReserved(absl::string_view name) {
+  static const auto* const kReserved =
+      new absl::flat_hash_set<absl::string_view>({
+          "Action", "FromProto", "ToProto", "entry", "match", "param", "result",
+          "action", "alignas", "alignof", "and", "asm", "auto", "bool", "break",
+          "case", "catch", "char", "class", "const", "const_cast", "constexpr",
+          "continue", "decltype", "default", "delete", "do", "double",
+          "dynamic_cast", "else", "enum", "explicit", "export", "extern",
+          "false", "float", "for", "friend", "goto", "if", "inline", "int",
+          "long", "mutable", "namespace", "new", "noexcept", "not", "nullptr",
+          "operator", "or", "priority", "private", "protected", "public",
+          "register", "reinterpret_cast", "return", "short", "signed", "sizeof",
+          "static", "static_assert", "static_cast", "struct", "switch",
+          "template", "this", "throw", "true", "try", "typedef", "typeid",
+          "typename", "union", "unsigned", "using", "virtual", "void",
+          "volatile", "while", "xor",
+      });
+  return kReserved->contains(name);
+}
+
+// Returns the P4 name in CamelCase, e.g. "Ipv4Lpm" for "ipv4_lpm" and
+// "HdrIpv4DstAddr" for "hdr.ipv4.dstAddr".
+std::string CamelCase(absl::string_view name) {
+  std::string result;
+  bool word_start = true;
+  for (char c : name) {
+    if (!std::isalnum(static_cast<unsigned char>(c))) {
+      word_start = true;
+      continue;
+    }
+    result.push_back(word_start ? std::toupper(static_cast<unsigned char>(c))
+                                : c);
+    word_start = false;
+  }
+  if (!result.empty() && std::isdigit(static_cast<unsigned char>(result[0]))) {
+    result.insert(0, "P4");
+  }
+  return result;
+}
+
+// Returns the P4 name as the name of a data member, e.g. "hdr_ipv4_dstAddr".
+std::string MemberName(absl::string_view name) {
+  std::string result;
+  for (char c : name) {
+    result.push_back(std::isalnum(static_cast<unsigned char>(c)) ? c : '_');
+  }
+  if (result.empty() || std::isdigit(static_cast<unsigned char>(result[0]))) {
+    result.insert(0, "_");
+  }
+  if (IsReserved(result)) result.push_back('_');
+  return result;
+}
+
+// Returns the C++ type of values of fields of the given bitwidth.
+absl::string_view ValueType(int bitwidth) {
+  return bitwidth > 0 && bitwidth <= 64 ? "uint64_t" : "std::string";
+}
+
+std::string Quote(absl::string_view name) {
+  return absl::StrCat("\"", absl::CEscape(name), "\"");
+}
+
+// The identifiers of a namespace or struct, to reject P4 names that map to
+// the same identifier. The constants that every struct has are taken from the
+// start.
+class Scope {
+ public:
+  Scope() : identifiers_({"kId", "kName", "kSize"}) {}
+
+  absl::Status Add(const std::string& identifier, absl::string_view name) {
+    if (identifier.empty()) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "'" << name << "' does not map to a C++ identifier.";
+    }
+    if (!identifiers_.insert(identifier).second) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "'" << name << "' maps to the identifier '" << identifier
+             << "', which is already taken.";
+    }
+    return absl::OkStatus();
+  }
+
+ private:
+  absl::flat_hash_set<std::string> identifiers_;
+};
+
+// Returns the name of the struct of an entity, which is based on its alias.
+absl::StatusOr<std::string> TypeName(const Preamble& preamble, Scope* scope) {
+  const std::string& name =
+      preamble.alias().empty() ? preamble.name() : preamble.alias();
+  std::string type_name = CamelCase(name);
+  RETURN_IF_ERROR(scope->Add(type_name, name));
+  return type_name;
+}
+
+// Opens the struct of an entity with its id and name.
+void AppendStructBegin(absl::string_view kind, absl::string_view type_name,
+                       const Preamble& preamble, std::string* out) {
+  absl::StrAppend(out, "// ", kind, " '", preamble.name(), "'.\n", "struct ",
+                  type_name, " {\n",
+                  "  static constexpr uint32_t kId = ", preamble.id(), ";\n",
+                  "  static constexpr absl::string_view kName = ",
+                  Quote(preamble.name()), ";\n");
+}
+
+// Appends the id and bitwidth constants of a match field, param or metadata
+// and returns the prefix of their names, e.g. "kDstAddr".
+absl::StatusOr<std::string> AppendFieldConstants(absl::string_view kind,
+                                                 absl::string_view name,
+                                                 uint32_t id, int bitwidth,
+                                                 Scope* scope,
+                                                 std::string* out) {
+  std::string constant = absl::StrCat("k", CamelCase(name));
+  RETURN_IF_ERROR(scope->Add(absl::StrCat(constant, "Id"), name));
+  RETURN_IF_ERROR(scope->Add(absl::StrCat(constant, "Bitwidth"), name));
+  absl::StrAppend(out, "  // ", kind, " '", name, "'.\n",
+                  "  static constexpr uint32_t ", constant, "Id = ", id, ";\n",
+                  "  static constexpr int ", constant, "Bitwidth = ", bitwidth,
+                  ";\n");
+  return constant;
+}
+
+absl::string_view MatchKind(MatchField::MatchType match_type) {
+  switch (match_type) {
+    case MatchField::EXACT:
+      return "Exact";
+    case MatchField::LPM:
+      return "Lpm";
+    case MatchField::TERNARY:
+      return "Ternary";
+    case MatchField::RANGE:
+      return "Range";
+    case MatchField::OPTIONAL:
+      return "Optional";
+    default:
+      return "";
+  }
+}
+
+// Appends the statement that returns an error for an unexpected id.
+void AppendUnexpectedId(absl::string_view kind, absl::string_view id,
+                        absl::string_view indent, std::string* out) {
+  absl::StrAppend(out, indent, "return ", kBindings, "UnexpectedIdError(\"",
+                  kind, "\", ", id, ", kName);\n");
+}
+
+absl::Status AppendAction(const p4::config::v1::Action& action,
+                          const std::string& type_name, std::string* out) {
+  AppendStructBegin("Action", type_name, action.preamble(), out);
+  Scope scope;
+  struct Param {
+    std::string constant;
+    std::string member;
+    const p4::config::v1::Action::Param* param;
+  };
+  std::vector<Param> params;
+  for (const auto& param : action.params()) {
+    ASSIGN_OR_RETURN(std::string constant,
+                     AppendFieldConstants("Param", param.name(), param.id(),
+                                          param.bitwidth(), &scope, out));
+    std::string member = MemberName(param.name());
+    RETURN_IF_ERROR(scope.Add(member, param.name()));
+    params.push_back({std::move(constant), std::move(member), &param});
+  }
+  if (!params.empty()) absl::StrAppend(out, "\n");
+  for (const Param& param : params) {
+    absl::StrAppend(out, "  ", ValueType(param.param->bitwidth()), " ",
+                    param.member, "{};\n");
+  }
+
+  absl::StrAppend(out, "\n  absl::Status ToProto(::p4::v1::Action* action) ",
+                  "const {\n",
+                  "    action->Clear();\n",
+                  "    action->set_action_id(kId);\n");
+  for (const Param& param : params) {
+    absl::StrAppend(out, "    RETURN_IF_ERROR(", kBindings, "AddParam(\n",
+                    "        ", param.constant, "Id, ", param.constant,
+                    "Bitwidth, ", Quote(param.param->name()), ", ",
+                    param.member, ", action));\n");
+  }
+  absl::StrAppend(out, "    return absl::OkStatus();\n  }\n");
+
+  absl::StrAppend(out, "\n  static absl::StatusOr<", type_name,
+                  "> FromProto(const ::p4::v1::Action& action) {\n",
+                  "    if (action.action_id() != kId) {\n");
+  AppendUnexpectedId("action", "action.action_id()", "      ", out);
+  absl::StrAppend(out, "    }\n    ", type_name, " result;\n");
+  if (params.empty()) {
+    absl::StrAppend(out, "    if (action.params_size() > 0) {\n");
+    AppendUnexpectedId("param", "action.params(0).param_id()", "      ", out);
+    absl::StrAppend(out, "    }\n");
+  } else {
+    absl::StrAppend(out,
+                    "    for (const ::p4::v1::Action::Param& param : "
+                    "action.params()) {\n",
+                    "      switch (param.param_id()) {\n");
+    for (const Param& param : params) {
+      absl::StrAppend(out, "        case ", param.constant, "Id:\n",
+                      "          RETURN_IF_ERROR(", kBindings, "ReadParam(\n",
+                      "              param, ", param.constant, "Bitwidth, ",
+                      Quote(param.param->name()), ", &result.", param.member,
+                      "));\n", "          break;\n");
+    }
+    absl::StrAppend(out, "        default:\n");
+    AppendUnexpectedId("param", "param.param_id()", "          ", out);
+    absl::StrAppend(out, "      }\n    }\n");
+  }
+  absl::StrAppend(out, "    return result;\n  }\n};\n\n");
+  return absl::OkStatus();
+}
+
+absl::Status AppendTable(
+    const Table& table, const std::string& type_name,
+    const absl::flat_hash_map<uint32_t, std::string>& action_types,
+    std::string* out) {
+  AppendStructBegin("Table", type_name, table.preamble(), out);
+  absl::StrAppend(out, "  static constexpr int64_t kSize = ", table.size(),
+                  ";\n");
+  Scope scope;
+  struct Field {
+    std::string constant;
+    std::string member;
+    const MatchField* match_field;
+    absl::string_view kind;
+  };
+  std::vector<Field> fields;
+  bool needs_priority = false;
+  for (const MatchField& match_field : table.match_fields()) {
+    absl::string_view kind = MatchKind(match_field.match_type());
+    if (kind.empty()) {
+      return gutil::UnimplementedErrorBuilder()
+             << "Match field '" << match_field.name() << "' of table '"
+             << table.preamble().name() << "' has an unsupported match type.";
+    }
+    needs_priority |= match_field.match_type() == MatchField::TERNARY ||
+                      match_field.match_type() == MatchField::RANGE ||
+                      match_field.match_type() == MatchField::OPTIONAL;
+    ASSIGN_OR_RETURN(
+        std::string constant,
+        AppendFieldConstants("Match field", match_field.name(),
+                             match_field.id(), match_field.bitwidth(), &scope,
+                             out));
+    std::string member = MemberName(match_field.name());
+    RETURN_IF_ERROR(scope.Add(member, match_field.name()));
+    fields.push_back(
+        {std::move(constant), std::move(member), &match_field, kind});
+  }
+
+  // The alternatives of the action variant, after absl::monostate.
+  std::vector<std::string> actions;
+  for (const auto& action_ref : table.action_refs()) {
+    auto it = action_types.find(action_ref.id());
+    if (it == action_types.end()) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Table '" << table.preamble().name()
+             << "' refers to the unknown action id " << action_ref.id()
+             << ".";
+    }
+    actions.push_back(absl::StrCat("actions::", it->second));
+  }
+  const bool indirect = table.implementation_id() != 0;
+  if (indirect) {
+    actions.push_back(absl::StrCat(kBindings, "ActionProfileMemberId"));
+    actions.push_back(absl::StrCat(kBindings, "ActionProfileGroupId"));
+  }
+  absl::StrAppend(out, "\n  using Action = absl::variant<absl::monostate");
+  for (const std::string& action : actions) {
+    absl::StrAppend(out, ",\n                               ", action);
+  }
+  absl::StrAppend(out, ">;\n\n");
+
+  if (!fields.empty()) {
+    absl::StrAppend(out, "  // Match fields. For all but exact matches, ",
+                    "absl::nullopt is a don't-care\n  // match.\n");
+  }
+  for (const Field& field : fields) {
+    const absl::string_view value_type =
+        ValueType(field.match_field->bitwidth());
+    switch (field.match_field->match_type()) {
+      case MatchField::EXACT:
+        absl::StrAppend(out, "  ", value_type, " ", field.member, "{};\n");
+        break;
+      case MatchField::OPTIONAL:
+        absl::StrAppend(out, "  absl::optional<", value_type, "> ",
+                        field.member, ";\n");
+        break;
+      default:
+        absl::StrAppend(out, "  absl::optional<", kBindings, field.kind,
+                        "Match<", value_type, ">> ", field.member, ";\n");
+        break;
+    }
+  }
+  if (needs_priority) absl::StrAppend(out, "  int32_t priority = 0;\n");
+  absl::StrAppend(out, "  // absl::monostate leaves the action unset, e.g. ",
+                  "for deletes.\n  Action action;\n");
+
+  // ToProto
+  absl::StrAppend(out, "\n  absl::Status ToProto(::p4::v1::TableEntry* entry) ",
+                  "const {\n",
+                  "    entry->Clear();\n",
+                  "    entry->set_table_id(kId);\n");
+  for (const Field& field : fields) {
+    const bool exact = field.match_field->match_type() == MatchField::EXACT;
+    std::string indent = exact ? "    " : "      ";
+    if (!exact) {
+      absl::StrAppend(out, "    if (", field.member, ".has_value()) {\n");
+    }
+    absl::StrAppend(out, indent, "RETURN_IF_ERROR(", kBindings, "Add",
+                    field.kind, "Match(\n", indent, "    ", field.constant,
+                    "Id, ", field.constant, "Bitwidth, ",
+                    Quote(field.match_field->name()), ", ",
+                    exact ? "" : "*", field.member, ", entry));\n");
+    if (!exact) absl::StrAppend(out, "    }\n");
+  }
+  if (needs_priority) {
+    absl::StrAppend(out, "    entry->set_priority(priority);\n");
+  }
+  const int num_actions = actions.size();
+  absl::StrAppend(out, "    switch (action.index()) {\n");
+  for (int i = 0; i < num_actions; ++i) {
+    absl::StrAppend(out, "      case ", i + 1, ":\n");
+    if (indirect && i == num_actions - 2) {
+      absl::StrAppend(out,
+                      "        entry->mutable_action()->"
+                      "set_action_profile_member_id(\n",
+                      "            absl::get<", i + 1, ">(action).id);\n");
+    } else if (indirect && i == num_actions - 1) {
+      absl::StrAppend(out,
+                      "        entry->mutable_action()->"
+                      "set_action_profile_group_id(\n",
+                      "            absl::get<", i + 1, ">(action).id);\n");
+    } else {
+      absl::StrAppend(out, "        RETURN_IF_ERROR(absl::get<", i + 1,
+                      ">(action).ToProto(\n",
+                      "            entry->mutable_action()->mutable_action()));"
+                      "\n");
+    }
+    absl::StrAppend(out, "        break;\n");
+  }
+  absl::StrAppend(out, "      default:\n        break;\n    }\n",
+                  "    return absl::OkStatus();\n  }\n");
+
+  // FromProto
+  absl::StrAppend(out, "\n  static absl::StatusOr<", type_name,
+                  "> FromProto(\n",
+                  "      const ::p4::v1::TableEntry& entry) {\n",
+                  "    if (entry.table_id() != kId) {\n");
+  AppendUnexpectedId("table", "entry.table_id()", "      ", out);
+  absl::StrAppend(out, "    }\n    ", type_name, " result;\n");
+  if (fields.empty()) {
+    absl::StrAppend(out, "    if (entry.match_size() > 0) {\n");
+    AppendUnexpectedId("match field", "entry.match(0).field_id()", "      ",
+                       out);
+    absl::StrAppend(out, "    }\n");
+  } else {
+    absl::StrAppend(out,
+                    "    for (const ::p4::v1::FieldMatch& match : "
+                    "entry.match()) {\n",
+                    "      switch (match.field_id()) {\n");
+    for (const Field& field : fields) {
+      const bool exact = field.match_field->match_type() == MatchField::EXACT;
+      absl::StrAppend(out, "        case ", field.constant, "Id:\n",
+                      "          RETURN_IF_ERROR(", kBindings, "Read",
+                      field.kind, "Match(\n", "              match, ",
+                      field.constant, "Bitwidth, ",
+                      Quote(field.match_field->name()), ",\n",
+                      "              &result.", field.member,
+                      exact ? "" : ".emplace()", "));\n",
+                      "          break;\n");
+    }
+    absl::StrAppend(out, "        default:\n");
+    AppendUnexpectedId("match field", "match.field_id()", "          ", out);
+    absl::StrAppend(out, "      }\n    }\n");
+  }
+  if (needs_priority) {
+    absl::StrAppend(out, "    result.priority = entry.priority();\n");
+  }
+  absl::StrAppend(out, "    switch (entry.action().type_case()) {\n",
+                  "      case ::p4::v1::TableAction::TYPE_NOT_SET:\n",
+                  "        break;\n",
+                  "      case ::p4::v1::TableAction::kAction:\n",
+                  "        switch (entry.action().action().action_id()) {\n");
+  const int num_direct = indirect ? num_actions - 2 : num_actions;
+  for (int i = 0; i < num_direct; ++i) {
+    absl::StrAppend(out, "          case ", actions[i], "::kId: {\n",
+                    "            ASSIGN_OR_RETURN(result.action, ", actions[i],
+                    "::FromProto(\n",
+                    "                entry.action().action()));\n",
+                    "            break;\n", "          }\n");
+  }
+  absl::StrAppend(out, "          default:\n");
+  AppendUnexpectedId("action", "entry.action().action().action_id()",
+                     "            ", out);
+  absl::StrAppend(out, "        }\n        break;\n");
+  if (indirect) {
+    absl::StrAppend(
+        out, "      case ::p4::v1::TableAction::kActionProfileMemberId:\n",
+        "        result.action = ", kBindings, "ActionProfileMemberId{\n",
+        "            entry.action().action_profile_member_id()};\n",
+        "        break;\n",
+        "      case ::p4::v1::TableAction::kActionProfileGroupId:\n",
+        "        result.action = ", kBindings, "ActionProfileGroupId{\n",
+        "            entry.action().action_profile_group_id()};\n",
+        "        break;\n");
+  }
+  absl::StrAppend(out, "      default:\n",
+                  "        return gutil::InvalidArgumentErrorBuilder()\n",
+                  "               << \"Unsupported action of table '\"",
+                  " << kName << \"'.\";\n",
+                  "    }\n    return result;\n  }\n};\n\n");
+  return absl::OkStatus();
+}
+
+// Appends the structs of entities that only have constants. `append_extra`
+// adds the constants that are specific to the kind of entity.
+template <typename T, typename AppendExtra>
+absl::Status AppendConstantStructs(
+    absl::string_view kind, absl::string_view cpp_namespace,
+    const google::protobuf::RepeatedPtrField<T>& entities,
+    AppendExtra append_extra, std::string* out) {
+  absl::StrAppend(out, "namespace ", cpp_namespace, " {\n\n");
+  Scope scope;
+  for (const T& entity : entities) {
+    ASSIGN_OR_RETURN(std::string type_name,
+                     TypeName(entity.preamble(), &scope));
+    AppendStructBegin(kind, type_name, entity.preamble(), out);
+    RETURN_IF_ERROR(append_extra(entity, out));
+    absl::StrAppend(out, "};\n\n");
+  }
+  absl::StrAppend(out, "}  // namespace ", cpp_namespace, "\n\n");
+  return absl::OkStatus();
+}
+
+void AppendSize(int64_t size, std::string* out) {
+  absl::StrAppend(out, "  static constexpr int64_t kSize = ", size, ";\n");
+}
+
+void AppendTableId(uint32_t table_id, std::string* out) {
+  absl::StrAppend(out, "  static constexpr uint32_t kTableId = ", table_id,
+                  ";\n");
+}
+
+}  // namespace
+
+absl::StatusOr<std::string> GenerateP4InfoBindings(
+    const P4Info& p4info, const P4InfoBindingsOptions& options) {
+  if (options.cpp_namespace.empty() || options.header_guard.empty()) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "The bindings need a namespace and an include guard.";
+  }
+  std::string out = absl::StrCat(
+      "// Generated by //p4runtime_cpp:p4info_codegen. Do not edit.\n\n",
+      "#ifndef ", options.header_guard, "\n", "#define ",
+      options.header_guard, "\n\n",
+      "#include <cstdint>\n"
+      "#include <string>\n\n"
+      "#include \"absl/status/status.h\"\n"
+      "#include \"absl/status/statusor.h\"\n"
+      "#include \"absl/strings/string_view.h\"\n"
+      "#include \"absl/types/optional.h\"\n"
+      "#include \"absl/types/variant.h\"\n"
+      "#include \"gutil/status.h\"\n"
+      "#include \"p4/v1/p4runtime.pb.h\"\n"
+      "#include \"p4runtime_cpp/p4info_bindings.h\"\n\n",
+      "namespace ", options.cpp_namespace, " {\n\n");
+
+  // Actions come first, as tables refer to them.
+  absl::StrAppend(&out, "namespace actions {\n\n");
+  absl::flat_hash_map<uint32_t, std::string> action_types;
+  Scope action_scope;
+  for (const auto& action : p4info.actions()) {
+    ASSIGN_OR_RETURN(std::string type_name,
+                     TypeName(action.preamble(), &action_scope));
+    RETURN_IF_ERROR(AppendAction(action, type_name, &out));
+    action_types[action.preamble().id()] = std::move(type_name);
+  }
+  absl::StrAppend(&out, "}  // namespace actions\n\n");
+
+  absl::StrAppend(&out, "namespace tables {\n\n");
+  Scope table_scope;
+  for (const Table& table : p4info.tables()) {
+    ASSIGN_OR_RETURN(std::string type_name,
+                     TypeName(table.preamble(), &table_scope));
+    RETURN_IF_ERROR(AppendTable(table, type_name, action_types, &out));
+  }
+  absl::StrAppend(&out, "}  // namespace tables\n\n");
+
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Action profile", "action_profiles", p4info.action_profiles(),
+      [](const p4::config::v1::ActionProfile& profile, std::string* out) {
+        AppendSize(profile.size(), out);
+        absl::StrAppend(out, "  static constexpr bool kWithSelector = ",
+                        profile.with_selector() ? "true" : "false", ";\n",
+                        "  static constexpr int32_t kMaxGroupSize = ",
+                        profile.max_group_size(), ";\n");
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Counter", "counters", p4info.counters(),
+      [](const p4::config::v1::Counter& counter, std::string* out) {
+        AppendSize(counter.size(), out);
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Direct counter", "direct_counters", p4info.direct_counters(),
+      [](const p4::config::v1::DirectCounter& counter, std::string* out) {
+        AppendTableId(counter.direct_table_id(), out);
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Meter", "meters", p4info.meters(),
+      [](const p4::config::v1::Meter& meter, std::string* out) {
+        AppendSize(meter.size(), out);
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Direct meter", "direct_meters", p4info.direct_meters(),
+      [](const p4::config::v1::DirectMeter& meter, std::string* out) {
+        AppendTableId(meter.direct_table_id(), out);
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Register", "registers", p4info.registers(),
+      [](const p4::config::v1::Register& reg, std::string* out) {
+        AppendSize(reg.size(), out);
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Digest", "digests", p4info.digests(),
+      [](const p4::config::v1::Digest&, std::string*) {
+        return absl::OkStatus();
+      },
+      &out));
+  RETURN_IF_ERROR(AppendConstantStructs(
+      "Controller packet metadata", "packet_metadata",
+      p4info.controller_packet_metadata(),
+      [](const p4::config::v1::ControllerPacketMetadata& header,
+         std::string* out) -> absl::Status {
+        Scope scope;
+        for (const auto& metadata : header.metadata()) {
+          RETURN_IF_ERROR(AppendFieldConstants("Metadata", metadata.name(),
+                                               metadata.id(),
+                                               metadata.bitwidth(), &scope,
+                                               out)
+                              .status());
+        }
+        return absl::OkStatus();
+      },
+      &out));
+
+  absl::StrAppend(&out, "}  // namespace ", options.cpp_namespace, "\n\n",
+                  "#endif  // ", options.header_guard, "\n");
+  return out;
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,34 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_P4INFO_CODEGEN_H_
+#define P4RUNTIME_CPP_P4INFO_CODEGEN_H_
+
+#include <string>
+
+#include "absl/status/statusor.h"
+#include "p4/config/v1/p4info.pb.h"
+
+namespace p4runtime_cpp {
+
+struct P4InfoBindingsOptions {
+  // The namespace of the bindings, e.g. "my_program::p4info".
+  std::string cpp_namespace;
+  // The include guard of the generated header.
+  std::string header_guard;
+};
+
+// Generates a C++ header with compile-time bindings of the P4 program that is
+// described by the P4Info. Every entity gets a struct named after its alias,
+// in a namespace per kind (tables, actions, counters, ...), with constexpr
+// ids, names, sizes and the ids and bitwidths of its match fields, params or
+// metadata. Tables and actions also get data members for their match fields
+// and params and ToProto/FromProto conversions, see p4info_bindings.h.
+// Usually run through the cc_p4info_library rule of p4info_library.bzl.
+absl::StatusOr<std::string> GenerateP4InfoBindings(
+    const p4::config::v1::P4Info& p4info,
+    const P4InfoBindingsOptions& options);
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_P4INFO_CODEGEN_H_
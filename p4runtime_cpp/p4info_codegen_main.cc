@@ -0,0 +1,58 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+// Generates the C++ bindings of a P4 program from its P4Info text file. Run by
+// the cc_p4info_library rule of p4info_library.bzl.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/status/status.h"
+#include "gutil/proto.h"
+#include "gutil/status.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4runtime_cpp/p4info_codegen.h"
+
+ABSL_FLAG(std::string, p4info, "", "P4Info text file of the P4 program.");
+ABSL_FLAG(std::string, cpp_namespace, "",
+          "Namespace of the bindings, e.g. my_program::p4info.");
+ABSL_FLAG(std::string, header_guard, "", "Include guard of the header.");
+ABSL_FLAG(std::string, output, "", "Header file to write.");
+
+namespace p4runtime_cpp {
+
+absl::Status Main() {
+  p4::config::v1::P4Info p4info;
+  RETURN_IF_ERROR(
+      gutil::ReadProtoFromFile(absl::GetFlag(FLAGS_p4info), &p4info));
+  P4InfoBindingsOptions options;
+  options.cpp_namespace = absl::GetFlag(FLAGS_cpp_namespace);
+  options.header_guard = absl::GetFlag(FLAGS_header_guard);
+  ASSIGN_OR_RETURN(std::string header,
+                   GenerateP4InfoBindings(p4info, options));
+
+  const std::string output = absl::GetFlag(FLAGS_output);
+  std::ofstream file(output);
+  file << header;
+  file.close();
+  if (!file) {
+    return gutil::UnavailableErrorBuilder() << "Failed to write " << output;
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace p4runtime_cpp
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Generates C++ bindings of a P4 program from its P4Info.");
+  absl::ParseCommandLine(argc, argv);
+
+  absl::Status status = p4runtime_cpp::Main();
+  if (!status.ok()) std::cerr << status << std::endl;
+  return status.raw_code();
+}
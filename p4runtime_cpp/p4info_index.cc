@@ -0,0 +1,116 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/p4info_index.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::config::v1::Action;
+using ::p4::config::v1::ControllerPacketMetadata;
+using ::p4::config::v1::MatchField;
+
+absl::StatusOr<std::shared_ptr<const P4InfoIndex>> P4InfoIndex::Create(
+    p4::config::v1::P4Info p4info) {
+  // Using `new` to access a private constructor.
+  std::shared_ptr<P4InfoIndex> index(new P4InfoIndex(std::move(p4info)));
+  RETURN_IF_ERROR(index->Build());
+  return index;
+}
+
+absl::Status P4InfoIndex::Build() {
+  RETURN_IF_ERROR(tables_.Build(p4info_.tables(), "table"));
+  RETURN_IF_ERROR(actions_.Build(p4info_.actions(), "action"));
+  RETURN_IF_ERROR(
+      action_profiles_.Build(p4info_.action_profiles(), "action profile"));
+  RETURN_IF_ERROR(counters_.Build(p4info_.counters(), "counter"));
+  RETURN_IF_ERROR(
+      direct_counters_.Build(p4info_.direct_counters(), "direct counter"));
+  RETURN_IF_ERROR(meters_.Build(p4info_.meters(), "meter"));
+  RETURN_IF_ERROR(
+      direct_meters_.Build(p4info_.direct_meters(), "direct meter"));
+  RETURN_IF_ERROR(controller_packet_metadata_.Build(
+      p4info_.controller_packet_metadata(), "controller packet metadata"));
+  RETURN_IF_ERROR(registers_.Build(p4info_.registers(), "register"));
+  RETURN_IF_ERROR(digests_.Build(p4info_.digests(), "digest"));
+
+  match_fields_.resize(p4info_.tables_size());
+  for (int i = 0; i < p4info_.tables_size(); ++i) {
+    const auto& table = p4info_.tables(i);
+    RETURN_IF_ERROR(match_fields_[i].Build(
+        table.match_fields(),
+        absl::StrCat("match field of table '", table.preamble().name(), "'")));
+  }
+  action_params_.resize(p4info_.actions_size());
+  for (int i = 0; i < p4info_.actions_size(); ++i) {
+    const auto& action = p4info_.actions(i);
+    RETURN_IF_ERROR(action_params_[i].Build(
+        action.params(),
+        absl::StrCat("param of action '", action.preamble().name(), "'")));
+  }
+  packet_metadata_.resize(p4info_.controller_packet_metadata_size());
+  for (int i = 0; i < p4info_.controller_packet_metadata_size(); ++i) {
+    const auto& header = p4info_.controller_packet_metadata(i);
+    RETURN_IF_ERROR(packet_metadata_[i].Build(
+        header.metadata(),
+        absl::StrCat("metadata of '", header.preamble().name(), "'")));
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<const P4InfoEntityIndex<MatchField>*> P4InfoIndex::MatchFields(
+    uint32_t table_id) const {
+  const int position = tables_.Position(table_id);
+  if (position == -1) {
+    return gutil::NotFoundErrorBuilder()
+           << "No table with id " << table_id << ".";
+  }
+  return &match_fields_[position];
+}
+
+absl::StatusOr<const P4InfoEntityIndex<Action::Param>*>
+P4InfoIndex::ActionParams(uint32_t action_id) const {
+  const int position = actions_.Position(action_id);
+  if (position == -1) {
+    return gutil::NotFoundErrorBuilder()
+           << "No action with id " << action_id << ".";
+  }
+  return &action_params_[position];
+}
+
+absl::StatusOr<const P4InfoEntityIndex<ControllerPacketMetadata::Metadata>*>
+P4InfoIndex::PacketMetadata(uint32_t header_id) const {
+  const int position = controller_packet_metadata_.Position(header_id);
+  if (position == -1) {
+    return gutil::NotFoundErrorBuilder()
+           << "No controller packet metadata with id " << header_id << ".";
+  }
+  return &packet_metadata_[position];
+}
+
+absl::StatusOr<const MatchField*> P4InfoIndex::GetMatchField(
+    uint32_t table_id, absl::string_view name) const {
+  ASSIGN_OR_RETURN(const auto* match_fields, MatchFields(table_id));
+  return match_fields->Get(name);
+}
+
+absl::StatusOr<const MatchField*> P4InfoIndex::GetMatchField(
+    uint32_t table_id, uint32_t field_id) const {
+  ASSIGN_OR_RETURN(const auto* match_fields, MatchFields(table_id));
+  return match_fields->Get(field_id);
+}
+
+absl::StatusOr<const Action::Param*> P4InfoIndex::GetActionParam(
+    uint32_t action_id, absl::string_view name) const {
+  ASSIGN_OR_RETURN(const auto* params, ActionParams(action_id));
+  return params->Get(name);
+}
+
+absl::StatusOr<const Action::Param*> P4InfoIndex::GetActionParam(
+    uint32_t action_id, uint32_t param_id) const {
+  ASSIGN_OR_RETURN(const auto* params, ActionParams(action_id));
+  return params->Get(param_id);
+}
+
+}  // namespace p4runtime_cpp
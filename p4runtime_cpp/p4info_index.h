@@ -0,0 +1,233 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_P4INFO_INDEX_H_
+#define P4RUNTIME_CPP_P4INFO_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/repeated_field.h"
+#include "gutil/status.h"
+#include "p4/config/v1/p4info.pb.h"
+
+namespace p4runtime_cpp {
+
+// Looks up the entities of one kind, e.g. the tables of a P4Info or the match
+// fields of a table, by name and by id. Top-level entities are also found by
+// their alias. The entities themselves are not copied; they stay where they
+// are in the P4Info, and the maps hold their positions.
+template <typename T>
+class P4InfoEntityIndex {
+ public:
+  P4InfoEntityIndex() = default;
+
+  // Indexes the given entities, which must outlive the index. `kind` names the
+  // entities in error messages.
+  absl::Status Build(const google::protobuf::RepeatedPtrField<T>& entities,
+                     std::string kind);
+
+  // Return the entity with the given name (or alias).
+  absl::StatusOr<const T*> Get(absl::string_view name) const {
+    auto it = by_name_.find(name);
+    if (it == by_name_.end()) {
+      return gutil::NotFoundErrorBuilder()
+             << "No " << kind_ << " named '" << name << "'.";
+    }
+    return &(*entities_)[it->second];
+  }
+  // Return the entity with the given id.
+  absl::StatusOr<const T*> Get(uint32_t id) const {
+    auto it = by_id_.find(id);
+    if (it == by_id_.end()) {
+      return gutil::NotFoundErrorBuilder()
+             << "No " << kind_ << " with id " << id << ".";
+    }
+    return &(*entities_)[it->second];
+  }
+  // Return the id of the entity with the given name (or alias).
+  absl::StatusOr<uint32_t> GetId(absl::string_view name) const {
+    ASSIGN_OR_RETURN(const T* entity, Get(name));
+    return Id(*entity);
+  }
+  // Return the position of the entity with the given id among the entities,
+  // or -1 if there is none.
+  int Position(uint32_t id) const {
+    auto it = by_id_.find(id);
+    return it == by_id_.end() ? -1 : it->second;
+  }
+
+  // Return all entities, in P4Info order.
+  const google::protobuf::RepeatedPtrField<T>& All() const {
+    return *entities_;
+  }
+
+ private:
+  // Top-level entities carry their id and names in a preamble.
+  template <typename U, typename = void>
+  struct HasPreamble : std::false_type {};
+  template <typename U>
+  struct HasPreamble<U, std::void_t<decltype(std::declval<U>().preamble())>>
+      : std::true_type {};
+
+  static uint32_t Id(const T& entity) {
+    if constexpr (HasPreamble<T>::value) {
+      return entity.preamble().id();
+    } else {
+      return entity.id();
+    }
+  }
+
+  std::string kind_;
+  const google::protobuf::RepeatedPtrField<T>* entities_ = nullptr;
+  absl::flat_hash_map<std::string, int> by_name_;
+  absl::flat_hash_map<uint32_t, int> by_id_;
+};
+
+// An index over all entities of a P4Info, built once per pipeline. Lookups by
+// name and id take constant time, for top-level entities as well as for the
+// match fields of tables, the params of actions and the metadata of
+// controller packet headers. Immutable once built, and so safe to share between
+// threads and sessions.
+class P4InfoIndex {
+ public:
+  // Builds the index over a copy of the P4Info. Fails for duplicate names or
+  // ids within a kind of entities.
+  static absl::StatusOr<std::shared_ptr<const P4InfoIndex>> Create(
+      p4::config::v1::P4Info p4info);
+
+  // Disable copy and move semantics; the entity indices point into the P4Info.
+  P4InfoIndex(const P4InfoIndex&) = delete;
+  P4InfoIndex& operator=(const P4InfoIndex&) = delete;
+
+  const p4::config::v1::P4Info& P4Info() const { return p4info_; }
+
+  const P4InfoEntityIndex<p4::config::v1::Table>& Tables() const {
+    return tables_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::Action>& Actions() const {
+    return actions_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::ActionProfile>& ActionProfiles()
+      const {
+    return action_profiles_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::Counter>& Counters() const {
+    return counters_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::DirectCounter>& DirectCounters()
+      const {
+    return direct_counters_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::Meter>& Meters() const {
+    return meters_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::DirectMeter>& DirectMeters() const {
+    return direct_meters_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::ControllerPacketMetadata>&
+  ControllerPacketMetadata() const {
+    return controller_packet_metadata_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::Register>& Registers() const {
+    return registers_;
+  }
+  const P4InfoEntityIndex<p4::config::v1::Digest>& Digests() const {
+    return digests_;
+  }
+
+  // Return the match fields of the table with the given id.
+  absl::StatusOr<const P4InfoEntityIndex<p4::config::v1::MatchField>*>
+  MatchFields(uint32_t table_id) const;
+  // Return the params of the action with the given id.
+  absl::StatusOr<const P4InfoEntityIndex<p4::config::v1::Action::Param>*>
+  ActionParams(uint32_t action_id) const;
+  // Return the metadata of the controller packet header with the given id.
+  absl::StatusOr<const P4InfoEntityIndex<
+      p4::config::v1::ControllerPacketMetadata::Metadata>*>
+  PacketMetadata(uint32_t header_id) const;
+
+  // Shorthands for looking up a single match field or action param.
+  absl::StatusOr<const p4::config::v1::MatchField*> GetMatchField(
+      uint32_t table_id, absl::string_view name) const;
+  absl::StatusOr<const p4::config::v1::MatchField*> GetMatchField(
+      uint32_t table_id, uint32_t field_id) const;
+  absl::StatusOr<const p4::config::v1::Action::Param*> GetActionParam(
+      uint32_t action_id, absl::string_view name) const;
+  absl::StatusOr<const p4::config::v1::Action::Param*> GetActionParam(
+      uint32_t action_id, uint32_t param_id) const;
+
+ private:
+  explicit P4InfoIndex(p4::config::v1::P4Info p4info)
+      : p4info_(std::move(p4info)) {}
+
+  absl::Status Build();
+
+  const p4::config::v1::P4Info p4info_;
+
+  P4InfoEntityIndex<p4::config::v1::Table> tables_;
+  P4InfoEntityIndex<p4::config::v1::Action> actions_;
+  P4InfoEntityIndex<p4::config::v1::ActionProfile> action_profiles_;
+  P4InfoEntityIndex<p4::config::v1::Counter> counters_;
+  P4InfoEntityIndex<p4::config::v1::DirectCounter> direct_counters_;
+  P4InfoEntityIndex<p4::config::v1::Meter> meters_;
+  P4InfoEntityIndex<p4::config::v1::DirectMeter> direct_meters_;
+  P4InfoEntityIndex<p4::config::v1::ControllerPacketMetadata>
+      controller_packet_metadata_;
+  P4InfoEntityIndex<p4::config::v1::Register> registers_;
+  P4InfoEntityIndex<p4::config::v1::Digest> digests_;
+
+  // Nested entities, in the same order as their parents.
+  std::vector<P4InfoEntityIndex<p4::config::v1::MatchField>> match_fields_;
+  std::vector<P4InfoEntityIndex<p4::config::v1::Action::Param>> action_params_;
+  std::vector<
+      P4InfoEntityIndex<p4::config::v1::ControllerPacketMetadata::Metadata>>
+      packet_metadata_;
+};
+
+template <typename T>
+absl::Status P4InfoEntityIndex<T>::Build(
+    const google::protobuf::RepeatedPtrField<T>& entities, std::string kind) {
+  kind_ = std::move(kind);
+  entities_ = &entities;
+  by_name_.reserve(entities.size());
+  by_id_.reserve(entities.size());
+  for (int i = 0; i < entities.size(); ++i) {
+    const T& entity = entities[i];
+    const uint32_t id = Id(entity);
+    if (!by_id_.emplace(id, i).second) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Duplicate " << kind_ << " id " << id << ".";
+    }
+    std::vector<absl::string_view> names;
+    if constexpr (HasPreamble<T>::value) {
+      names.push_back(entity.preamble().name());
+      // The alias defaults to the name.
+      if (!entity.preamble().alias().empty() &&
+          entity.preamble().alias() != entity.preamble().name()) {
+        names.push_back(entity.preamble().alias());
+      }
+    } else {
+      names.push_back(entity.name());
+    }
+    for (absl::string_view name : names) {
+      if (!by_name_.emplace(name, i).second) {
+        return gutil::InvalidArgumentErrorBuilder()
+               << "Duplicate " << kind_ << " name '" << name << "'.";
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_P4INFO_INDEX_H_
@@ -0,0 +1,66 @@
+# Copyright 2021-present Open Networking Foundation
+# SPDX-License-Identifier: Apache-2.0
+
+"""Generates compile-time C++ bindings of a P4 program from its P4Info."""
+
+load("@rules_cc//cc:defs.bzl", "cc_library")
+
+def _header_guard(path):
+    guard = [c if c.isalnum() else "_" for c in path.upper().elems()]
+    return "".join(guard) + "_"
+
+def _package_path(file):
+    package = native.package_name()
+    return package + "/" + file if package else file
+
+def cc_p4info_library(name, p4info, cpp_namespace, **kwargs):
+    """Generates a cc_library with the header `<name>.p4info.h`.
+
+    The header has a struct per table, action, action profile, counter, meter,
+    register, digest and controller packet metadata header, with constexpr ids
+    and bitwidths. Tables and actions also convert to and from their protos.
+    See p4info_codegen.h.
+
+    Example:
+      cc_p4info_library(
+          name = "my_program",
+          p4info = "my_program.p4info.txt",
+          cpp_namespace = "my_program::p4info",
+      )
+
+    Args:
+      name: Name of the cc_library.
+      p4info: P4Info text file.
+      cpp_namespace: Namespace of the bindings.
+      **kwargs: Passed on to the cc_library, e.g. visibility.
+    """
+    header = name + ".p4info.h"
+    codegen = str(Label("//p4runtime_cpp:p4info_codegen"))
+    native.genrule(
+        name = name + "_codegen",
+        srcs = [p4info],
+        outs = [header],
+        tools = [codegen],
+        cmd = ("$(location {codegen}) --p4info=$< --cpp_namespace={namespace}" +
+               " --header_guard={guard} --output=$@").format(
+            codegen = codegen,
+            namespace = cpp_namespace,
+            guard = _header_guard(_package_path(header)),
+        ),
+        visibility = ["//visibility:private"],
+    )
+    cc_library(
+        name = name,
+        hdrs = [header],
+        deps = [
+            Label("//gutil:status"),
+            Label("//p4runtime_cpp:p4info_bindings"),
+            Label("@com_github_p4lang_p4runtime//:p4runtime_cc_proto"),
+            Label("@com_google_absl//absl/status"),
+            Label("@com_google_absl//absl/status:statusor"),
+            Label("@com_google_absl//absl/strings"),
+            Label("@com_google_absl//absl/types:optional"),
+            Label("@com_google_absl//absl/types:variant"),
+        ],
+        **kwargs
+    )
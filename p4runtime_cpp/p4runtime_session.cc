@@ -4,18 +4,26 @@
 
 #include "p4runtime_cpp/p4runtime_session.h"
 
+#include <algorithm>
+#include <functional>
+#include <iterator>
 #include <string>
 
 #include "glog/logging.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "grpcpp/channel.h"
 #include "grpcpp/create_channel.h"
+#include "gutil/parallel.h"
 #include "gutil/status.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
 #include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/bytestring.h"
+#include "p4runtime_cpp/table_entry_key.h"
 
 namespace p4runtime_cpp {
 using ::p4::config::v1::P4Info;
 using ::p4::v1::CounterEntry;
+using ::p4::v1::Entity;
 using ::p4::v1::GetForwardingPipelineConfigRequest;
 using ::p4::v1::GetForwardingPipelineConfigResponse;
 using ::p4::v1::P4Runtime;
@@ -90,6 +98,13 @@ absl::StatusOr<std::unique_ptr<P4RuntimeSession>> P4RuntimeSession::Create(
            << response.ShortDebugString();
   }
 
+  // From here on, the stream channel is only written by the writer and read by
+  // the dispatcher.
+  session->stream_writer_ = absl::make_unique<StreamMessageWriter>(
+      session->stream_channel_.get(), P4MaxPendingStreamMessages());
+  session->stream_dispatcher_ = absl::make_unique<StreamMessageDispatcher>(
+      session->stream_channel_context_.get(), session->stream_channel_.get());
+
   // Move is needed to make the older compiler happy.
   // See: go/totw/labs/should-i-return-std-move.
   return std::move(session);
@@ -113,21 +128,348 @@ std::unique_ptr<P4RuntimeSession> P4RuntimeSession::Default(
       new P4RuntimeSession(device_id, std::move(stub), device_id));
 }
 
-absl::StatusOr<ReadResponse> SendReadRequest(P4RuntimeSession* session,
-                                             const ReadRequest& read_request) {
+absl::Status P4RuntimeSession::RegisterStreamMessageHandler(
+    p4::v1::StreamMessageResponse::UpdateCase update_case,
+    StreamMessageHandler handler, int queue_capacity) {
+  if (stream_dispatcher_ == nullptr) {
+    return gutil::FailedPreconditionErrorBuilder()
+           << "The session has no stream channel to receive messages from.";
+  }
+  return stream_dispatcher_->RegisterHandler(update_case, std::move(handler),
+                                             queue_capacity);
+}
+
+absl::Status P4RuntimeSession::SendPacketOut(p4::v1::PacketOut packet) {
+  p4::v1::StreamMessageRequest message;
+  *message.mutable_packet() = std::move(packet);
+  return SendStreamMessage(std::move(message));
+}
+
+absl::Status P4RuntimeSession::SendStreamMessage(
+    p4::v1::StreamMessageRequest message) {
+  if (stream_writer_ == nullptr) {
+    return gutil::FailedPreconditionErrorBuilder()
+           << "The session has no stream channel to send messages on.";
+  }
+  return stream_writer_->Send(std::move(message));
+}
+
+namespace {
+
+// Reads the response stream of `read_request` into the chunks returned by
+// `next_chunk` and hands every entity to `callback`. The chunk of the read that
+// ends the stream stays empty.
+absl::Status ReadIntoChunks(P4RuntimeSession* session,
+                            const ReadRequest& read_request,
+                            const std::function<ReadResponse*()>& next_chunk,
+                            const ReadEntityCallback& callback) {
   grpc::ClientContext context;
   auto reader = session->Stub().Read(&context, read_request);
 
-  ReadResponse response;
-  ReadResponse partial_response;
-  while (reader->Read(&partial_response)) {
-    response.MergeFrom(partial_response);
+  absl::Status callback_status;
+  while (callback_status.ok()) {
+    ReadResponse* chunk = next_chunk();
+    if (!reader->Read(chunk)) break;
+    for (auto& entity : *chunk->mutable_entities()) {
+      callback_status = callback(&entity);
+      if (!callback_status.ok()) break;
+    }
+  }
+  if (!callback_status.ok()) {
+    // Stop the server from sending the rest of the stream.
+    context.TryCancel();
+    reader->Finish();
+    return callback_status;
+  }
+
+  return gutil::GrpcStatusToAbslStatus(reader->Finish());
+}
+
+ReadRequest TableEntriesReadRequest(P4RuntimeSession* session,
+                                    bool include_counter_data,
+                                    bool include_meter_config) {
+  ReadRequest read_request;
+  read_request.set_device_id(session->DeviceId());
+  read_request.add_entities()->mutable_table_entry();
+  if (include_counter_data) {
+    read_request.mutable_entities(0)
+        ->mutable_table_entry()
+        ->mutable_counter_data();
+  }
+  if (include_meter_config) {
+    read_request.mutable_entities(0)
+        ->mutable_table_entry()
+        ->mutable_meter_config();
+  }
+  return read_request;
+}
+
+absl::Status CheckTableEntryInReadResponse(const Entity& entity,
+                                           bool include_counter_data,
+                                           bool include_meter_config) {
+  if (!entity.has_table_entry()) {
+    return gutil::InternalErrorBuilder()
+           << "Entity in the read response has no table entry: "
+           << entity.DebugString();
+  }
+  if (include_counter_data && !entity.table_entry().has_counter_data()) {
+    return gutil::InternalErrorBuilder()
+           << "TableEntry in the read response has no counter data: "
+           << entity.table_entry().DebugString();
+  }
+  if (include_meter_config && !entity.table_entry().has_meter_config()) {
+    return gutil::InternalErrorBuilder()
+           << "TableEntry in the read response has no meter config: "
+           << entity.table_entry().DebugString();
+  }
+  return absl::OkStatus();
+}
+
+// Reads the table entries from the switch, bypassing the cache. Unless
+// `require_meter_config`, requested meter configs may be missing from entries.
+absl::StatusOr<std::vector<TableEntry>> ReadTableEntriesFromSwitch(
+    P4RuntimeSession* session, bool include_counter_data,
+    bool include_meter_config, bool require_meter_config) {
+  ReadRequest read_request = TableEntriesReadRequest(
+      session, include_counter_data, include_meter_config);
+
+  std::vector<TableEntry> table_entries;
+  RETURN_IF_ERROR(SendReadRequest(
+      session, read_request, [&](Entity* entity) -> absl::Status {
+        RETURN_IF_ERROR(CheckTableEntryInReadResponse(
+            *entity, include_counter_data,
+            include_meter_config && require_meter_config));
+        table_entries.push_back(std::move(*entity->mutable_table_entry()));
+        return absl::OkStatus();
+      }));
+  return std::move(table_entries);
+}
+
+// Returns one read request per group of `options.tables_per_read` tables.
+std::vector<ReadRequest> TableGroupReadRequests(
+    P4RuntimeSession* session, const P4Info& p4info,
+    const ParallelReadOptions& options) {
+  const int tables_per_read = std::max(options.tables_per_read, 1);
+  std::vector<ReadRequest> read_requests;
+  for (int i = 0; i < p4info.tables_size(); ++i) {
+    if (i % tables_per_read == 0) {
+      read_requests.emplace_back();
+      read_requests.back().set_device_id(session->DeviceId());
+    }
+    TableEntry* table_entry =
+        read_requests.back().add_entities()->mutable_table_entry();
+    table_entry->set_table_id(p4info.tables(i).preamble().id());
+    if (options.include_counter_data) table_entry->mutable_counter_data();
+    if (options.include_meter_config) table_entry->mutable_meter_config();
+  }
+  return read_requests;
+}
+
+ReadRequest CounterEntriesReadRequest(P4RuntimeSession* session,
+                                      int counter_id) {
+  ReadRequest read_request;
+  read_request.set_device_id(session->DeviceId());
+  read_request.add_entities()->mutable_counter_entry()->set_counter_id(
+      counter_id);
+  return read_request;
+}
+
+// Returns a response chunk on `*arena`, which is replaced by a new arena unless
+// it is still unused. Readers hand the arena to their result once the chunk has
+// delivered an entry, so chunks that stay empty, like the one of the read that
+// ends the stream, are never added to the result.
+ReadResponse* NewChunkOnArena(std::unique_ptr<google::protobuf::Arena>* arena) {
+  if (*arena == nullptr) {
+    *arena = absl::make_unique<google::protobuf::Arena>();
+  } else {
+    (*arena)->Reset();
   }
+  return google::protobuf::Arena::CreateMessage<ReadResponse>(arena->get());
+}
 
-  grpc::Status reader_status = reader->Finish();
-  if (!reader_status.ok()) {
-    return gutil::GrpcStatusToAbslStatus(reader_status);
+// Returns the filter with the byte strings of its match fields in canonical
+// form, i.e. without leading zero bytes, as in the entries read from the
+// switch. The bitwidths are unknown, so the bytes are taken as they are.
+TableEntryFilter CanonicalFilter(const TableEntryFilter& filter) {
+  auto canonicalize = [](std::string* bytes) {
+    std::string canonical;
+    // Never fails, as the bitwidth is that of the bytes.
+    CanonicalizeBytestring(*bytes, bytes->size() * 8, &canonical);
+    *bytes = std::move(canonical);
+  };
+  TableEntryFilter canonical_filter = filter;
+  for (p4::v1::FieldMatch& field_match : canonical_filter.match) {
+    switch (field_match.field_match_type_case()) {
+      case p4::v1::FieldMatch::kExact:
+        canonicalize(field_match.mutable_exact()->mutable_value());
+        break;
+      case p4::v1::FieldMatch::kTernary:
+        canonicalize(field_match.mutable_ternary()->mutable_value());
+        canonicalize(field_match.mutable_ternary()->mutable_mask());
+        break;
+      case p4::v1::FieldMatch::kLpm:
+        canonicalize(field_match.mutable_lpm()->mutable_value());
+        break;
+      case p4::v1::FieldMatch::kRange:
+        canonicalize(field_match.mutable_range()->mutable_low());
+        canonicalize(field_match.mutable_range()->mutable_high());
+        break;
+      case p4::v1::FieldMatch::kOptional:
+        canonicalize(field_match.mutable_optional()->mutable_value());
+        break;
+      default:
+        break;
+    }
   }
+  return canonical_filter;
+}
+
+// Returns true if the table entry matches the filter, whose match fields must
+// be canonical.
+bool MatchesCanonicalFilter(const TableEntry& entry,
+                            const TableEntryFilter& filter) {
+  if (filter.table_id != 0 && entry.table_id() != filter.table_id) {
+    return false;
+  }
+  if (filter.priority != 0 && entry.priority() != filter.priority) {
+    return false;
+  }
+  for (const auto& filter_match : filter.match) {
+    auto it = std::find_if(entry.match().begin(), entry.match().end(),
+                           [&](const p4::v1::FieldMatch& field_match) {
+                             return field_match.field_id() ==
+                                    filter_match.field_id();
+                           });
+    if (it == entry.match().end() || !FieldMatchEq(*it, filter_match)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+absl::Status CheckCounterEntryInReadResponse(const Entity& entity) {
+  if (!entity.has_counter_entry()) {
+    return gutil::InternalErrorBuilder()
+           << "Entity in the read response has no counter entry: "
+           << entity.DebugString();
+  }
+  return absl::OkStatus();
+}
+
+// Records the outcome of a write in the table entry cache of the session, if it
+// is enabled.
+void RecordWriteInTableEntryCache(P4RuntimeSession* session,
+                                  const WriteRequest& write_request,
+                                  const grpc::Status& status) {
+  TableEntryCache* cache = session->GetTableEntryCache();
+  if (cache == nullptr) return;
+  if (status.ok()) {
+    cache->Apply(write_request);
+  } else {
+    cache->Apply(write_request,
+                 WriteRequestGrpcStatusToUpdateStatuses(
+                     status, write_request.updates_size()));
+  }
+}
+
+// Returns the number of bytes an update of `update_size` bytes adds to the
+// serialized WriteRequest it is part of: the field tag, the length prefix and
+// the update itself.
+size_t UpdateFieldSize(size_t update_size) {
+  return 1 +
+         google::protobuf::io::CodedOutputStream::VarintSize64(update_size) +
+         update_size;
+}
+
+// Builds `num_updates` updates with `fill_update` and sends them in as many
+// write requests as needed to stay within `limits`. The size of every update is
+// computed exactly once, right after it has been built in place. If
+// `update_statuses` is set, batches are sent one by one until all have been
+// sent, and the status of every update is appended to it; otherwise the first
+// failing batch aborts the write.
+absl::Status SendUpdatesInBatches(
+    P4RuntimeSession* session, int num_updates,
+    const std::function<void(int index, Update* update)>& fill_update,
+    const WriteBatchLimits& limits,
+    std::vector<absl::Status>* update_statuses = nullptr) {
+  WriteRequest batch;
+  batch.set_device_id(session->DeviceId());
+  *batch.mutable_election_id() = session->ElectionId();
+  const size_t header_size = batch.ByteSizeLong();
+
+  // Batches are either sent one by one or, if several may be in flight, through
+  // a pipeline that reports the failing batch itself.
+  std::unique_ptr<WritePipeline> pipeline;
+  if (limits.max_batches_in_flight > 1 && update_statuses == nullptr) {
+    WritePipeline::Options options;
+    options.max_in_flight = limits.max_batches_in_flight;
+    pipeline = absl::make_unique<WritePipeline>(session, std::move(options));
+  }
+  int batch_index = 0;
+  absl::Status first_error;
+  std::vector<absl::Status> batch_statuses;
+  auto send_batch = [&](int first_update) -> absl::Status {
+    if (pipeline != nullptr) return pipeline->Send(batch);
+    if (update_statuses != nullptr) {
+      absl::Status status = SendWriteRequest(session, batch, &batch_statuses);
+      std::move(batch_statuses.begin(), batch_statuses.end(),
+                std::back_inserter(*update_statuses));
+      if (first_error.ok()) first_error = std::move(status);
+      return absl::OkStatus();
+    }
+    RETURN_IF_ERROR(SendWriteRequest(session, batch))
+        << "Failed to send write batch " << batch_index << " of "
+        << batch.updates_size() << " updates, starting at update "
+        << first_update << ".";
+    return absl::OkStatus();
+  };
+
+  size_t batch_size = header_size;
+  for (int i = 0; i < num_updates; ++i) {
+    Update* update = batch.add_updates();
+    fill_update(i, update);
+    const size_t update_size = UpdateFieldSize(update->ByteSizeLong());
+    if (batch.updates_size() > 1 &&
+        (batch.updates_size() > limits.max_updates ||
+         batch_size + update_size > static_cast<size_t>(limits.max_bytes))) {
+      // The new update does not fit anymore; send the batch without it and
+      // start the next batch with it.
+      std::unique_ptr<Update> overflow(batch.mutable_updates()->ReleaseLast());
+      RETURN_IF_ERROR(send_batch(i - batch.updates_size()));
+      ++batch_index;
+      batch.clear_updates();
+      batch.mutable_updates()->AddAllocated(overflow.release());
+      batch_size = header_size;
+    }
+    batch_size += update_size;
+  }
+  if (batch.updates_size() > 0) {
+    RETURN_IF_ERROR(send_batch(num_updates - batch.updates_size()));
+  }
+  if (pipeline != nullptr) return pipeline->Finish();
+  return first_error;
+}
+
+}  // namespace
+
+absl::Status SendReadRequest(P4RuntimeSession* session,
+                             const ReadRequest& read_request,
+                             const ReadEntityCallback& callback) {
+  // The chunk is reused for every message of the stream, which bounds the
+  // memory held by this function to the largest chunk the server sends.
+  ReadResponse partial_response;
+  return ReadIntoChunks(
+      session, read_request, [&]() { return &partial_response; }, callback);
+}
+
+absl::StatusOr<ReadResponse> SendReadRequest(P4RuntimeSession* session,
+                                             const ReadRequest& read_request) {
+  ReadResponse response;
+  RETURN_IF_ERROR(SendReadRequest(
+      session, read_request, [&](Entity* entity) -> absl::Status {
+        response.add_entities()->Swap(entity);
+        return absl::OkStatus();
+      }));
 
   return std::move(response);
 }
@@ -144,10 +486,125 @@ absl::Status SendWriteRequest(P4RuntimeSession* session,
   if (!status.ok()) {
     LOG(ERROR) << WriteRequestGrpcStatusToString(status);
   }
+  RecordWriteInTableEntryCache(session, write_request, status);
+
+  return gutil::GrpcStatusToAbslStatus(status);
+}
+
+absl::Status SendWriteRequest(P4RuntimeSession* session,
+                              const WriteRequest& write_request,
+                              std::vector<absl::Status>* update_statuses) {
+  grpc::ClientContext context;
+  // Empty message; intentionally discarded.
+  WriteResponse response;
 
+  ::grpc::Status status =
+      session->Stub().Write(&context, write_request, &response);
+  *update_statuses = WriteRequestGrpcStatusToUpdateStatuses(
+      status, write_request.updates_size());
+  if (session->GetTableEntryCache() != nullptr) {
+    session->GetTableEntryCache()->Apply(write_request, *update_statuses);
+  }
   return gutil::GrpcStatusToAbslStatus(status);
 }
 
+absl::Status SendBatchedWriteRequests(P4RuntimeSession* session,
+                                      absl::Span<const Update> updates,
+                                      const WriteBatchLimits& limits) {
+  return SendUpdatesInBatches(
+      session, updates.size(),
+      [&](int index, Update* update) { *update = updates[index]; }, limits);
+}
+
+absl::Status SendBatchedWriteRequests(
+    P4RuntimeSession* session, absl::Span<const Update> updates,
+    const WriteBatchLimits& limits,
+    std::vector<absl::Status>* update_statuses) {
+  update_statuses->clear();
+  update_statuses->reserve(updates.size());
+  return SendUpdatesInBatches(
+      session, updates.size(),
+      [&](int index, Update* update) { *update = updates[index]; }, limits,
+      update_statuses);
+}
+
+struct WritePipeline::PendingWrite {
+  // Only kept if the session has a table entry cache that needs to record the
+  // write once it has completed.
+  std::unique_ptr<WriteRequest> write_request;
+  grpc::ClientContext context;
+  std::unique_ptr<grpc::ClientAsyncResponseReader<WriteResponse>> reader;
+  // Empty message; intentionally discarded.
+  WriteResponse response;
+  grpc::Status status;
+  bool done = false;
+};
+
+WritePipeline::WritePipeline(P4RuntimeSession* session, Options options)
+    : session_(session), options_(std::move(options)) {}
+
+WritePipeline::~WritePipeline() {
+  Finish().IgnoreError();
+  completion_queue_.Shutdown();
+  void* tag;
+  bool ok;
+  while (completion_queue_.Next(&tag, &ok)) {
+  }
+}
+
+absl::Status WritePipeline::Send(const WriteRequest& write_request) {
+  while (static_cast<int>(pending_writes_.size()) >=
+         std::max(options_.max_in_flight, 1)) {
+    WaitForCompletion();
+  }
+  if (options_.stop_on_first_error && !first_error_.ok()) return first_error_;
+
+  // The request is serialized when the call is started, so it does not need to
+  // outlive this function.
+  auto pending_write = absl::make_unique<PendingWrite>();
+  if (session_->GetTableEntryCache() != nullptr) {
+    pending_write->write_request =
+        absl::make_unique<WriteRequest>(write_request);
+  }
+  pending_write->reader = session_->Stub().AsyncWrite(
+      &pending_write->context, write_request, &completion_queue_);
+  pending_write->reader->Finish(&pending_write->response,
+                                &pending_write->status, pending_write.get());
+  pending_writes_.push_back(std::move(pending_write));
+  return absl::OkStatus();
+}
+
+absl::Status WritePipeline::Finish() {
+  while (!pending_writes_.empty()) WaitForCompletion();
+  return first_error_;
+}
+
+void WritePipeline::WaitForCompletion() {
+  void* tag;
+  bool ok;
+  if (!completion_queue_.Next(&tag, &ok)) return;
+  static_cast<PendingWrite*>(tag)->done = true;
+
+  while (!pending_writes_.empty() && pending_writes_.front()->done) {
+    const grpc::Status& grpc_status = pending_writes_.front()->status;
+    if (pending_writes_.front()->write_request != nullptr) {
+      RecordWriteInTableEntryCache(
+          session_, *pending_writes_.front()->write_request, grpc_status);
+    }
+    absl::Status status = gutil::GrpcStatusToAbslStatus(grpc_status);
+    if (!status.ok()) {
+      LOG(ERROR) << WriteRequestGrpcStatusToString(grpc_status);
+      if (first_error_.ok()) {
+        first_error_ = gutil::StatusBuilder(status)
+                       << "Write request " << next_index_ << " failed.";
+      }
+    }
+    if (options_.on_completion) options_.on_completion(next_index_, status);
+    pending_writes_.pop_front();
+    ++next_index_;
+  }
+}
+
 absl::StatusOr<std::vector<TableEntry>> ReadTableEntries(
     P4RuntimeSession* session) {
   return ReadTableEntries(session, false, false);
@@ -156,65 +613,235 @@ absl::StatusOr<std::vector<TableEntry>> ReadTableEntries(
 absl::StatusOr<std::vector<TableEntry>> ReadTableEntries(
     P4RuntimeSession* session, bool include_counter_data,
     bool include_meter_config) {
-  ReadRequest read_request;
-  read_request.set_device_id(session->DeviceId());
-  read_request.add_entities()->mutable_table_entry();
-  if (include_counter_data) {
-    read_request.mutable_entities(0)
-        ->mutable_table_entry()
-        ->mutable_counter_data();
-  }
-  if (include_meter_config) {
-    read_request.mutable_entities(0)
-        ->mutable_table_entry()
-        ->mutable_meter_config();
+  TableEntryCache* cache = session->GetTableEntryCache();
+  if (cache != nullptr && cache->IsSynced() && !include_counter_data &&
+      !include_meter_config) {
+    return cache->Entries();
   }
-  ASSIGN_OR_RETURN(ReadResponse read_response,
-                   SendReadRequest(session, read_request));
+  return ReadTableEntriesFromSwitch(session, include_counter_data,
+                                    include_meter_config,
+                                    /*require_meter_config=*/true);
+}
 
-  std::vector<TableEntry> table_entries;
-  table_entries.reserve(read_response.entities().size());
-  for (const auto& entity : read_response.entities()) {
-    if (!entity.has_table_entry())
-      return gutil::InternalErrorBuilder()
-             << "Entity in the read response has no table entry: "
-             << entity.DebugString();
-    if (include_counter_data && !entity.table_entry().has_counter_data()) {
-      return gutil::InternalErrorBuilder()
-             << "TableEntry in the read response has no counter data: "
-             << entity.table_entry().DebugString();
+absl::StatusOr<std::vector<TableEntry>> ReadTableEntriesWithMeterConfigs(
+    P4RuntimeSession* session) {
+  return ReadTableEntriesFromSwitch(session, /*include_counter_data=*/false,
+                                    /*include_meter_config=*/true,
+                                    /*require_meter_config=*/false);
+}
+
+absl::StatusOr<FilteredTableEntries> ReadTableEntries(
+    P4RuntimeSession* session, const TableEntryFilter& original_filter) {
+  const TableEntryFilter filter = CanonicalFilter(original_filter);
+  if (!filter.match.empty() && filter.table_id == 0) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Filtering by match fields requires a table id.";
+  }
+  for (const auto& field_match : filter.match) {
+    if (field_match.field_id() == 0) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Filter match field without a field id: "
+             << field_match.ShortDebugString();
     }
-    if (include_meter_config && !entity.table_entry().has_meter_config()) {
-      return gutil::InternalErrorBuilder()
-             << "TableEntry in the read response has no meter config: "
-             << entity.table_entry().DebugString();
+  }
+
+  FilteredTableEntries result;
+  TableEntryCache* cache = session->GetTableEntryCache();
+  if (cache != nullptr && cache->IsSynced() && !filter.include_counter_data &&
+      !filter.include_meter_config) {
+    result.filtered_by_target = false;
+    std::vector<TableEntry> entries = filter.table_id == 0
+                                          ? cache->Entries()
+                                          : cache->Entries(filter.table_id);
+    for (TableEntry& entry : entries) {
+      if (MatchesCanonicalFilter(entry, filter)) {
+        result.entries.push_back(std::move(entry));
+      }
     }
-    table_entries.push_back(std::move(entity.table_entry()));
+    return std::move(result);
+  }
+
+  ReadRequest read_request = TableEntriesReadRequest(
+      session, filter.include_counter_data, filter.include_meter_config);
+  TableEntry* filter_entry = read_request.mutable_entities(0)
+                                 ->mutable_table_entry();
+  filter_entry->set_table_id(filter.table_id);
+  filter_entry->set_priority(filter.priority);
+  for (const auto& field_match : filter.match) {
+    *filter_entry->add_match() = field_match;
+  }
+
+  RETURN_IF_ERROR(SendReadRequest(
+      session, read_request, [&](Entity* entity) -> absl::Status {
+        RETURN_IF_ERROR(CheckTableEntryInReadResponse(
+            *entity, filter.include_counter_data,
+            filter.include_meter_config));
+        if (!MatchesCanonicalFilter(entity->table_entry(), filter)) {
+          result.filtered_by_target = false;
+          return absl::OkStatus();
+        }
+        result.entries.push_back(std::move(*entity->mutable_table_entry()));
+        return absl::OkStatus();
+      }));
+  if (!result.filtered_by_target) {
+    VLOG(1) << "The switch did not apply the table entry read filter; "
+               "filtered on the client instead.";
+  }
+  return std::move(result);
+}
+
+bool TableEntryMatchesFilter(const TableEntry& entry,
+                             const TableEntryFilter& filter) {
+  return MatchesCanonicalFilter(entry, CanonicalFilter(filter));
+}
+
+absl::StatusOr<TableEntryFilter> TableEntryFilterFromNames(
+    const P4InfoIndex& p4info_index, absl::string_view table_name,
+    const std::vector<std::pair<std::string, p4::v1::FieldMatch>>& match,
+    int32_t priority) {
+  ASSIGN_OR_RETURN(const p4::config::v1::Table* table,
+                   p4info_index.Tables().Get(table_name));
+  ASSIGN_OR_RETURN(const auto* match_fields,
+                   p4info_index.MatchFields(table->preamble().id()));
+
+  TableEntryFilter filter;
+  filter.table_id = table->preamble().id();
+  filter.priority = priority;
+  for (const auto& [field_name, field_match] : match) {
+    ASSIGN_OR_RETURN(const p4::config::v1::MatchField* match_field,
+                     match_fields->Get(field_name));
+    p4::v1::FieldMatch& filter_match = filter.match.emplace_back(field_match);
+    filter_match.set_field_id(match_field->id());
+  }
+  return std::move(filter);
+}
+
+absl::StatusOr<TableEntryFilter> TableEntryFilterFromNames(
+    const P4Info& p4info, absl::string_view table_name,
+    const std::vector<std::pair<std::string, p4::v1::FieldMatch>>& match,
+    int32_t priority) {
+  ASSIGN_OR_RETURN(std::shared_ptr<const P4InfoIndex> p4info_index,
+                   P4InfoIndex::Create(p4info));
+  return TableEntryFilterFromNames(*p4info_index, table_name, match, priority);
+}
+
+absl::Status ResyncTableEntryCache(P4RuntimeSession* session) {
+  TableEntryCache* cache = session->GetTableEntryCache();
+  if (cache == nullptr) {
+    return gutil::FailedPreconditionErrorBuilder()
+           << "The table entry cache is not enabled for this session.";
+  }
+  ASSIGN_OR_RETURN(std::vector<TableEntry> table_entries,
+                   ReadTableEntriesFromSwitch(session, false, false, false));
+  cache->Replace(std::move(table_entries));
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::vector<TableEntry>> ReadTableEntriesInParallel(
+    P4RuntimeSession* session, const P4Info& p4info,
+    const ParallelReadOptions& options) {
+  std::vector<ReadRequest> read_requests =
+      TableGroupReadRequests(session, p4info, options);
+
+  // Every group is collected separately, so the reads need no synchronization.
+  std::vector<std::vector<TableEntry>> group_entries(read_requests.size());
+  RETURN_IF_ERROR(gutil::ParallelFor(
+      read_requests.size(), options.num_threads, [&](int group) {
+        return SendReadRequest(
+            session, read_requests[group],
+            [&](Entity* entity) -> absl::Status {
+              RETURN_IF_ERROR(CheckTableEntryInReadResponse(
+                  *entity, options.include_counter_data,
+                  options.include_meter_config));
+              group_entries[group].push_back(
+                  std::move(*entity->mutable_table_entry()));
+              return absl::OkStatus();
+            });
+      }));
+
+  size_t num_entries = 0;
+  for (const auto& entries : group_entries) num_entries += entries.size();
+  std::vector<TableEntry> table_entries;
+  table_entries.reserve(num_entries);
+  for (auto& entries : group_entries) {
+    std::move(entries.begin(), entries.end(),
+              std::back_inserter(table_entries));
   }
   return std::move(table_entries);
 }
 
+absl::Status ReadTableEntriesInParallel(P4RuntimeSession* session,
+                                        const P4Info& p4info,
+                                        const ParallelReadOptions& options,
+                                        const ReadEntityCallback& callback) {
+  std::vector<ReadRequest> read_requests =
+      TableGroupReadRequests(session, p4info, options);
+  return gutil::ParallelFor(
+      read_requests.size(), options.num_threads, [&](int group) {
+        return SendReadRequest(
+            session, read_requests[group],
+            [&](Entity* entity) -> absl::Status {
+              RETURN_IF_ERROR(CheckTableEntryInReadResponse(
+                  *entity, options.include_counter_data,
+                  options.include_meter_config));
+              return callback(entity);
+            });
+      });
+}
+
+absl::StatusOr<std::unique_ptr<ArenaReadResult<TableEntry>>>
+ReadTableEntriesOnArena(P4RuntimeSession* session, bool include_counter_data,
+                        bool include_meter_config) {
+  ReadRequest read_request = TableEntriesReadRequest(
+      session, include_counter_data, include_meter_config);
+
+  // Every chunk is parsed straight onto an arena that the result keeps alive,
+  // so the entries can be referenced in place.
+  auto result = absl::make_unique<ArenaReadResult<TableEntry>>();
+  std::unique_ptr<google::protobuf::Arena> chunk_arena;
+  RETURN_IF_ERROR(ReadIntoChunks(
+      session, read_request, [&]() { return NewChunkOnArena(&chunk_arena); },
+      [&](Entity* entity) -> absl::Status {
+        RETURN_IF_ERROR(CheckTableEntryInReadResponse(
+            *entity, include_counter_data, include_meter_config));
+        if (chunk_arena != nullptr) result->AddArena(std::move(chunk_arena));
+        result->AddEntry(&entity->table_entry());
+        return absl::OkStatus();
+      }));
+  return std::move(result);
+}
+
 absl::StatusOr<std::vector<CounterEntry>> ReadCounterEntries(
     P4RuntimeSession* session, int counter_id) {
-  ReadRequest read_request;
-  read_request.set_device_id(session->DeviceId());
-  read_request.add_entities()->mutable_counter_entry()->set_counter_id(
-      counter_id);
-  ASSIGN_OR_RETURN(ReadResponse read_response,
-                   SendReadRequest(session, read_request));
+  ReadRequest read_request = CounterEntriesReadRequest(session, counter_id);
 
   std::vector<CounterEntry> counter_entries;
-  counter_entries.reserve(read_response.entities().size());
-  for (const auto& entity : read_response.entities()) {
-    if (!entity.has_counter_entry())
-      return gutil::InternalErrorBuilder()
-             << "Entity in the read response has no counter entry: "
-             << entity.DebugString();
-    counter_entries.push_back(std::move(entity.counter_entry()));
-  }
+  RETURN_IF_ERROR(SendReadRequest(
+      session, read_request, [&](Entity* entity) -> absl::Status {
+        RETURN_IF_ERROR(CheckCounterEntryInReadResponse(*entity));
+        counter_entries.push_back(std::move(*entity->mutable_counter_entry()));
+        return absl::OkStatus();
+      }));
   return std::move(counter_entries);
 }
 
+absl::StatusOr<std::unique_ptr<ArenaReadResult<CounterEntry>>>
+ReadCounterEntriesOnArena(P4RuntimeSession* session, int counter_id) {
+  ReadRequest read_request = CounterEntriesReadRequest(session, counter_id);
+
+  auto result = absl::make_unique<ArenaReadResult<CounterEntry>>();
+  std::unique_ptr<google::protobuf::Arena> chunk_arena;
+  RETURN_IF_ERROR(ReadIntoChunks(
+      session, read_request, [&]() { return NewChunkOnArena(&chunk_arena); },
+      [&](Entity* entity) -> absl::Status {
+        RETURN_IF_ERROR(CheckCounterEntryInReadResponse(*entity));
+        if (chunk_arena != nullptr) result->AddArena(std::move(chunk_arena));
+        result->AddEntry(&entity->counter_entry());
+        return absl::OkStatus();
+      }));
+  return std::move(result);
+}
+
 absl::Status ClearTableEntries(P4RuntimeSession* session) {
   ASSIGN_OR_RETURN(auto table_entries, ReadTableEntries(session));
   // Early return if there is nothing to clear.
@@ -223,17 +850,15 @@ absl::Status ClearTableEntries(P4RuntimeSession* session) {
 }
 
 absl::Status RemoveTableEntries(P4RuntimeSession* session,
-                                absl::Span<const TableEntry> entries) {
-  WriteRequest clear_request;
-  clear_request.set_device_id(session->DeviceId());
-  *clear_request.mutable_election_id() = session->ElectionId();
-
-  for (const auto& table_entry : entries) {
-    Update* update = clear_request.add_updates();
-    update->set_type(Update::DELETE);
-    *update->mutable_entity()->mutable_table_entry() = table_entry;
-  }
-  return SendWriteRequest(session, clear_request);
+                                absl::Span<const TableEntry> entries,
+                                const WriteBatchLimits& limits) {
+  return SendUpdatesInBatches(
+      session, entries.size(),
+      [&](int index, Update* update) {
+        update->set_type(Update::DELETE);
+        *update->mutable_entity()->mutable_table_entry() = entries[index];
+      },
+      limits);
 }
 
 absl::Status InstallTableEntry(P4RuntimeSession* session,
@@ -242,31 +867,39 @@ absl::Status InstallTableEntry(P4RuntimeSession* session,
 }
 
 absl::Status InstallTableEntries(P4RuntimeSession* session,
-                                 absl::Span<const TableEntry> entries) {
-  WriteRequest batch_write_request;
-  batch_write_request.set_device_id(session->DeviceId());
-  *batch_write_request.mutable_election_id() = session->ElectionId();
+                                 absl::Span<const TableEntry> entries,
+                                 const WriteBatchLimits& limits) {
+  return SendUpdatesInBatches(
+      session, entries.size(),
+      [&](int index, Update* update) {
+        update->set_type(Update::INSERT);
+        *update->mutable_entity()->mutable_table_entry() = entries[index];
+      },
+      limits);
+}
 
-  for (const auto& entry : entries) {
-    Update* update = batch_write_request.add_updates();
-    update->set_type(Update::INSERT);
-    *update->mutable_entity()->mutable_table_entry() = entry;
-  }
-  return SendWriteRequest(session, batch_write_request);
+absl::Status ModifyTableEntries(P4RuntimeSession* session,
+                                absl::Span<const TableEntry> entries,
+                                const WriteBatchLimits& limits) {
+  return SendUpdatesInBatches(
+      session, entries.size(),
+      [&](int index, Update* update) {
+        update->set_type(Update::MODIFY);
+        *update->mutable_entity()->mutable_table_entry() = entries[index];
+      },
+      limits);
 }
 
 absl::Status ModifyIndirectCounterEntries(
-    P4RuntimeSession* session, absl::Span<const CounterEntry> entries) {
-  WriteRequest batch_write_request;
-  batch_write_request.set_device_id(session->DeviceId());
-  *batch_write_request.mutable_election_id() = session->ElectionId();
-
-  for (const auto& entry : entries) {
-    Update* update = batch_write_request.add_updates();
-    update->set_type(Update::MODIFY);
-    *update->mutable_entity()->mutable_counter_entry() = entry;
-  }
-  return SendWriteRequest(session, batch_write_request);
+    P4RuntimeSession* session, absl::Span<const CounterEntry> entries,
+    const WriteBatchLimits& limits) {
+  return SendUpdatesInBatches(
+      session, entries.size(),
+      [&](int index, Update* update) {
+        update->set_type(Update::MODIFY);
+        *update->mutable_entity()->mutable_counter_entry() = entries[index];
+      },
+      limits);
 }
 
 absl::Status SetForwardingPipelineConfig(P4RuntimeSession* session,
@@ -343,4 +976,52 @@ std::string WriteRequestGrpcStatusToString(const grpc::Status& status) {
   return readable_status;
 }
 
+std::vector<absl::Status> WriteRequestGrpcStatusToUpdateStatuses(
+    const grpc::Status& status, int num_updates) {
+  std::vector<absl::Status> update_statuses;
+  if (status.ok()) {
+    update_statuses.resize(num_updates);
+    return update_statuses;
+  }
+
+  google::rpc::Status inner_status;
+  if (!status.error_details().empty() &&
+      inner_status.ParseFromString(status.error_details()) &&
+      inner_status.details_size() == num_updates) {
+    update_statuses.reserve(num_updates);
+    p4::v1::Error p4_error;
+    for (const auto& inner_status_detail : inner_status.details()) {
+      if (!inner_status_detail.UnpackTo(&p4_error)) break;
+      update_statuses.emplace_back(
+          static_cast<absl::StatusCode>(p4_error.canonical_code()),
+          p4_error.message());
+    }
+    if (static_cast<int>(update_statuses.size()) == num_updates) {
+      return update_statuses;
+    }
+  }
+
+  update_statuses.assign(num_updates, gutil::GrpcStatusToAbslStatus(status));
+  return update_statuses;
+}
+
+WriteRequest WriteRequestWithFailedUpdates(
+    const WriteRequest& write_request,
+    absl::Span<const absl::Status> update_statuses) {
+  WriteRequest failed_updates;
+  failed_updates.set_device_id(write_request.device_id());
+  if (write_request.has_election_id()) {
+    *failed_updates.mutable_election_id() = write_request.election_id();
+  }
+  failed_updates.set_atomicity(write_request.atomicity());
+  for (int i = 0; i < write_request.updates_size(); ++i) {
+    if (i < static_cast<int>(update_statuses.size()) &&
+        update_statuses[i].ok()) {
+      continue;
+    }
+    *failed_updates.add_updates() = write_request.updates(i);
+  }
+  return failed_updates;
+}
+
 }  // namespace p4runtime_cpp
@@ -5,6 +5,8 @@
 #ifndef P4RUNTIME_CPP_P4RUNTIME_SESSION_H_
 #define P4RUNTIME_CPP_P4RUNTIME_SESSION_H_
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -14,12 +16,19 @@
 #include "absl/numeric/int128.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "absl/time/clock.h"
 #include "absl/time/time.h"
 #include "absl/types/span.h"
+#include "google/protobuf/arena.h"
+#include "grpcpp/completion_queue.h"
 #include "grpcpp/security/credentials.h"
+#include "p4/config/v1/p4info.pb.h"
 #include "p4/v1/p4runtime.grpc.pb.h"
 #include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4info_index.h"
+#include "p4runtime_cpp/stream_channel.h"
+#include "p4runtime_cpp/table_entry_cache.h"
 
 namespace p4runtime_cpp {
 // The maximum metadata size that a P4Runtime client should accept.  This is
@@ -39,6 +48,71 @@ constexpr int P4GRPCMaxMessageReceiveSize() {
   return 256 * 1024 * 1024;
 }
 
+// The maximum number of updates that the batching write functions put into a
+// single WriteRequest. This keeps the per-update errors of a failed batch well
+// within P4GRPCMaxMetadataSize.
+constexpr int P4MaxUpdatesPerWriteRequest() { return 10000; }
+
+// The maximum serialized size of a WriteRequest built by the batching write
+// functions.
+constexpr int64_t P4MaxWriteRequestSize() {
+  // 4MB. This is the default maximum message size of gRPC servers.
+  return 4 * 1024 * 1024;
+}
+
+// The maximum number of stream messages, e.g. packet-outs, that may wait to be
+// written on the stream channel of a session.
+constexpr int P4MaxPendingStreamMessages() {
+  // A few seconds worth of punted control traffic at tens of thousands of
+  // packets per second.
+  return 64 * 1024;
+}
+
+// Limits used to split a large write into several WriteRequests.
+struct WriteBatchLimits {
+  // The maximum number of updates per WriteRequest.
+  int max_updates = P4MaxUpdatesPerWriteRequest();
+  // The maximum serialized size of a WriteRequest in bytes. An update that
+  // exceeds this limit on its own is still sent, in a request of its own.
+  int64_t max_bytes = P4MaxWriteRequestSize();
+  // The maximum number of batches that are in flight at the same time. With
+  // more than one, the batches are sent through a WritePipeline.
+  int max_batches_in_flight = 1;
+};
+
+// Options for reading table entries with concurrent reads of table groups.
+struct ParallelReadOptions {
+  // The maximum number of reads that are in flight at the same time.
+  int num_threads = 4;
+  // The number of tables that are read by a single read request.
+  int tables_per_read = 1;
+  bool include_counter_data = false;
+  bool include_meter_config = false;
+};
+
+// A filter for reading table entries, which is sent to the switch as part of
+// the read request. Unset fields match any entry.
+struct TableEntryFilter {
+  // The table to read; 0 reads all tables.
+  uint32_t table_id = 0;
+  // Match fields that the entries must have, with exactly these values. Entries
+  // may have further match fields. Requires a table id.
+  std::vector<p4::v1::FieldMatch> match;
+  // The priority of the entries; 0 matches any priority.
+  int32_t priority = 0;
+  bool include_counter_data = false;
+  bool include_meter_config = false;
+};
+
+// The table entries read with a filter.
+struct FilteredTableEntries {
+  std::vector<p4::v1::TableEntry> entries;
+  // True if the switch applied the filter. False if the switch returned entries
+  // outside of the filter, or if the entries were read from the table entry
+  // cache, and the filter has been applied by the client instead.
+  bool filtered_by_target = true;
+};
+
 // Generates an election id that is monotonically increasing with time.
 // Specifically, the upper 64 bits are the unix timestamp in seconds, and the
 // lower 64 bits are 0. This is compatible with election-systems that use the
@@ -85,6 +159,42 @@ class P4RuntimeSession {
   // Return the P4Runtime stub.
   p4::v1::P4Runtime::Stub& Stub() { return *stub_; }
 
+  // Attach a table entry cache to this session. Successful table entry writes
+  // sent through this session are recorded in it, and table entry reads without
+  // counter data or meter config are answered from it instead of the switch,
+  // once ResyncTableEntryCache has filled it. Until then, reads go to the
+  // switch.
+  void EnableTableEntryCache() {
+    table_entry_cache_ = absl::make_unique<TableEntryCache>();
+  }
+  // Return the table entry cache, or nullptr if it is not enabled.
+  TableEntryCache* GetTableEntryCache() { return table_entry_cache_.get(); }
+
+  // Register the handler for the stream messages of the given kind (e.g.
+  // packet-ins or digests). Messages are read from the stream channel by a
+  // background thread and are handed to the handler on a thread of its own;
+  // up to `queue_capacity` messages are buffered before further ones of this
+  // kind are dropped. Not available on the default session.
+  absl::Status RegisterStreamMessageHandler(
+      p4::v1::StreamMessageResponse::UpdateCase update_case,
+      StreamMessageHandler handler, int queue_capacity = 1024);
+  // Queue a packet-out for sending on the stream channel. Packets are written
+  // in the order they are queued, in bursts, by a background thread; this
+  // neither blocks on the stream channel nor means the packet has been sent.
+  // Returns ResourceExhausted while too many packets are waiting to be
+  // written. Thread-safe. Not available on the default session.
+  absl::Status SendPacketOut(p4::v1::PacketOut packet);
+  // Queue any message for sending on the stream channel, like SendPacketOut.
+  absl::Status SendStreamMessage(p4::v1::StreamMessageRequest message);
+
+  // Return the number of stream messages that have been dropped because no
+  // handler was registered for them or the handler fell behind.
+  int64_t DroppedStreamMessages() const {
+    return stream_dispatcher_ == nullptr
+               ? 0
+               : stream_dispatcher_->DroppedMessages();
+  }
+
  private:
   P4RuntimeSession(uint32_t device_id,
                    std::unique_ptr<p4::v1::P4Runtime::Stub> stub,
@@ -110,6 +220,97 @@ class P4RuntimeSession {
   std::unique_ptr<grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
                                            p4::v1::StreamMessageResponse>>
       stream_channel_;
+
+  // Optional client-side mirror of the installed table entries.
+  std::unique_ptr<TableEntryCache> table_entry_cache_;
+
+  // Write and read the stream channel once arbitration is done. Declared after
+  // the stream channel, so that they are destroyed before it. The dispatcher
+  // is destroyed first, which cancels the stream channel and so unblocks any
+  // write in progress.
+  std::unique_ptr<StreamMessageWriter> stream_writer_;
+  std::unique_ptr<StreamMessageDispatcher> stream_dispatcher_;
+};
+
+// The result of a read whose response chunks are allocated on protobuf arenas,
+// one per chunk. Entries are handed out in place, without being copied out of
+// the chunks they were received in, and are all released at once with the
+// result.
+template <typename T>
+class ArenaReadResult {
+ public:
+  ArenaReadResult() = default;
+
+  // Disable copy and move semantics; the entries point into the arenas.
+  ArenaReadResult(const ArenaReadResult&) = delete;
+  ArenaReadResult& operator=(const ArenaReadResult&) = delete;
+
+  // Take ownership of an arena that holds entries.
+  void AddArena(std::unique_ptr<google::protobuf::Arena> arena) {
+    arenas_.push_back(std::move(arena));
+  }
+  // Return the entries in the order they were received.
+  absl::Span<const T* const> Entries() const { return entries_; }
+  // Add an entry that is owned by one of the arenas.
+  void AddEntry(const T* entry) { entries_.push_back(entry); }
+
+ private:
+  std::vector<std::unique_ptr<google::protobuf::Arena>> arenas_;
+  std::vector<const T*> entries_;
+};
+
+// Sends write requests asynchronously on the stub of a session, keeping up to a
+// fixed number of them in flight. Completions are reported in the order in
+// which the requests were sent, regardless of the order in which the switch
+// answers them. Not thread-safe.
+class WritePipeline {
+ public:
+  // Invoked once for every sent request, in order, with the index of the
+  // request (counting from 0) and the result of the write.
+  using CompletionCallback =
+      std::function<void(int64_t index, const absl::Status& status)>;
+
+  struct Options {
+    // The maximum number of requests that are in flight at the same time.
+    int max_in_flight = 8;
+    // Whether to stop sending requests once a write has failed.
+    bool stop_on_first_error = true;
+    // Optional; invoked for every completed request.
+    CompletionCallback on_completion;
+  };
+
+  WritePipeline(P4RuntimeSession* session, Options options);
+  // Waits for all requests that are still in flight.
+  ~WritePipeline();
+
+  // Disable copy semantics.
+  WritePipeline(const WritePipeline&) = delete;
+  WritePipeline& operator=(const WritePipeline&) = delete;
+
+  // Sends the given request once fewer than `max_in_flight` requests are in
+  // flight. With `stop_on_first_error`, returns the first failure reported so
+  // far instead of sending the request.
+  absl::Status Send(const p4::v1::WriteRequest& write_request);
+
+  // Waits for all requests in flight and returns the first failure, if any.
+  absl::Status Finish();
+
+ private:
+  struct PendingWrite;
+
+  // Waits for the next completion and reports all writes that are done, in
+  // order.
+  void WaitForCompletion();
+
+  P4RuntimeSession* session_;
+  Options options_;
+  grpc::CompletionQueue completion_queue_;
+  // Writes that have not been reported yet, in the order they were sent.
+  std::deque<std::unique_ptr<PendingWrite>> pending_writes_;
+  // The index of the first write in `pending_writes_`.
+  int64_t next_index_ = 0;
+  // The first failure reported so far.
+  absl::Status first_error_;
 };
 
 // Create P4Runtime stub.
@@ -119,7 +320,21 @@ std::unique_ptr<p4::v1::P4Runtime::Stub> CreateP4RuntimeStub(
 
 // Free-standing functions that operate on a P4RuntimeSession.
 
-// Sends a read request.
+// Invoked once for every entity of a streamed read response. The entity is
+// owned by the response chunk that is currently being processed and is only
+// valid for the duration of the call, but callers may move out of it. Returning
+// a non-OK status cancels the read.
+using ReadEntityCallback = std::function<absl::Status(p4::v1::Entity* entity)>;
+
+// Sends a read request and hands every entity to `callback` as soon as the
+// response chunk containing it has been received. Only a single chunk is held
+// in memory at any time. Returns the first error of either the RPC or the
+// callback.
+absl::Status SendReadRequest(P4RuntimeSession* session,
+                             const p4::v1::ReadRequest& read_request,
+                             const ReadEntityCallback& callback);
+
+// Sends a read request and collects all entities into a single response.
 absl::StatusOr<p4::v1::ReadResponse> SendReadRequest(
     P4RuntimeSession* session, const p4::v1::ReadRequest& read_request);
 
@@ -127,21 +342,109 @@ absl::StatusOr<p4::v1::ReadResponse> SendReadRequest(
 absl::Status SendWriteRequest(P4RuntimeSession* session,
                               const p4::v1::WriteRequest& write_request);
 
-// Reads table entries.
+// Sends a write request and sets `update_statuses` to the status of each of its
+// updates, in order. Returns the status of the write as a whole; nothing is
+// logged.
+absl::Status SendWriteRequest(P4RuntimeSession* session,
+                              const p4::v1::WriteRequest& write_request,
+                              std::vector<absl::Status>* update_statuses);
+
+// Sends the given updates in as many write requests as needed to stay within
+// `limits`. The batches are sent back-to-back in order, and the first failing
+// batch aborts the write.
+absl::Status SendBatchedWriteRequests(
+    P4RuntimeSession* session, absl::Span<const p4::v1::Update> updates,
+    const WriteBatchLimits& limits = WriteBatchLimits());
+
+// Sends the given updates in as many write requests as needed to stay within
+// `limits`, one after the other, and sets `update_statuses` to the status of
+// each update, in order. Failing batches do not stop the later ones. Returns
+// the status of the first failing batch as a whole.
+absl::Status SendBatchedWriteRequests(
+    P4RuntimeSession* session, absl::Span<const p4::v1::Update> updates,
+    const WriteBatchLimits& limits,
+    std::vector<absl::Status>* update_statuses);
+
+// Reads table entries. Reads without counter data and meter config are
+// answered by the table entry cache of the session, if it is enabled.
 absl::StatusOr<std::vector<p4::v1::TableEntry>> ReadTableEntries(
     P4RuntimeSession* session);
 absl::StatusOr<std::vector<p4::v1::TableEntry>> ReadTableEntries(
     P4RuntimeSession* session, bool include_counter_data,
     bool include_meter_config);
 
+// Reads table entries with their meter configs from the switch. Unlike
+// ReadTableEntries with `include_meter_config`, entries without a meter config,
+// i.e. of tables without direct meters or at the default meter config, do not
+// fail the read.
+absl::StatusOr<std::vector<p4::v1::TableEntry>>
+ReadTableEntriesWithMeterConfigs(P4RuntimeSession* session);
+
+// Reads the table entries that match the filter. The filter is sent to the
+// switch, so that only the matching entries are transferred; should the switch
+// ignore (part of) the filter, the entries are filtered on the client. Answered
+// by the table entry cache of the session, if it is enabled and no counter data
+// or meter config is requested.
+absl::StatusOr<FilteredTableEntries> ReadTableEntries(
+    P4RuntimeSession* session, const TableEntryFilter& filter);
+
+// Returns true if the table entry matches the filter.
+bool TableEntryMatchesFilter(const p4::v1::TableEntry& entry,
+                             const TableEntryFilter& filter);
+
+// Builds a filter for the table with the given name or alias in the P4Info.
+// The match fields are given by name; their field ids are filled in.
+absl::StatusOr<TableEntryFilter> TableEntryFilterFromNames(
+    const P4InfoIndex& p4info_index, absl::string_view table_name,
+    const std::vector<std::pair<std::string, p4::v1::FieldMatch>>& match = {},
+    int32_t priority = 0);
+
+// One-shot version of TableEntryFilterFromNames that also builds the index.
+// Consider building a P4InfoIndex once if you need more than one filter.
+absl::StatusOr<TableEntryFilter> TableEntryFilterFromNames(
+    const p4::config::v1::P4Info& p4info, absl::string_view table_name,
+    const std::vector<std::pair<std::string, p4::v1::FieldMatch>>& match = {},
+    int32_t priority = 0);
+
+// Replaces the contents of the table entry cache of the session with the table
+// entries read from the switch, after which reads are answered by the cache.
+// Entries are read without meter config, like the reads the cache answers.
+absl::Status ResyncTableEntryCache(P4RuntimeSession* session);
+
+// Reads the entries of all tables in `p4info`, with one read per group of
+// `options.tables_per_read` tables and up to `options.num_threads` reads in
+// flight at the same time. The results are merged in the order of the groups,
+// i.e. in the order of the tables in `p4info`.
+absl::StatusOr<std::vector<p4::v1::TableEntry>> ReadTableEntriesInParallel(
+    P4RuntimeSession* session, const p4::config::v1::P4Info& p4info,
+    const ParallelReadOptions& options = ParallelReadOptions());
+
+// Same as above, but streams the entities to `callback` as they arrive instead
+// of merging them. The callback is invoked concurrently from several threads,
+// only with entities that pass the same checks as above.
+absl::Status ReadTableEntriesInParallel(P4RuntimeSession* session,
+                                        const p4::config::v1::P4Info& p4info,
+                                        const ParallelReadOptions& options,
+                                        const ReadEntityCallback& callback);
+
+// Reads table entries onto an arena, without copying them.
+absl::StatusOr<std::unique_ptr<ArenaReadResult<p4::v1::TableEntry>>>
+ReadTableEntriesOnArena(P4RuntimeSession* session, bool include_counter_data,
+                        bool include_meter_config);
+
 // Reads indirect counter entries.
 // TODO(max): passing in raw the counter id is ugly.
 absl::StatusOr<std::vector<p4::v1::CounterEntry>> ReadCounterEntries(
     P4RuntimeSession* session, int counter_id);
 
-// Removes table entries on the switch.
-absl::Status RemoveTableEntries(P4RuntimeSession* session,
-                                absl::Span<const p4::v1::TableEntry> entries);
+// Reads indirect counter entries onto an arena, without copying them.
+absl::StatusOr<std::unique_ptr<ArenaReadResult<p4::v1::CounterEntry>>>
+ReadCounterEntriesOnArena(P4RuntimeSession* session, int counter_id);
+
+// Removes table entries on the switch, split into batches as needed.
+absl::Status RemoveTableEntries(
+    P4RuntimeSession* session, absl::Span<const p4::v1::TableEntry> entries,
+    const WriteBatchLimits& limits = WriteBatchLimits());
 
 // Clears the table entries
 absl::Status ClearTableEntries(P4RuntimeSession* session);
@@ -150,13 +453,21 @@ absl::Status ClearTableEntries(P4RuntimeSession* session);
 absl::Status InstallTableEntry(P4RuntimeSession* session,
                                const p4::v1::TableEntry& entry);
 
-// Installs the given table entries on the switch.
-absl::Status InstallTableEntries(P4RuntimeSession* session,
-                                 absl::Span<const p4::v1::TableEntry> entries);
+// Installs the given table entries on the switch, split into batches as
+// needed.
+absl::Status InstallTableEntries(
+    P4RuntimeSession* session, absl::Span<const p4::v1::TableEntry> entries,
+    const WriteBatchLimits& limits = WriteBatchLimits());
 
-// Writes the given counter entries on the switch.
+// Modifies the given table entries on the switch, split into batches as needed.
+absl::Status ModifyTableEntries(
+    P4RuntimeSession* session, absl::Span<const p4::v1::TableEntry> entries,
+    const WriteBatchLimits& limits = WriteBatchLimits());
+
+// Writes the given counter entries on the switch, split into batches as needed.
 absl::Status ModifyIndirectCounterEntries(
-    P4RuntimeSession* session, absl::Span<const p4::v1::CounterEntry> entries);
+    P4RuntimeSession* session, absl::Span<const p4::v1::CounterEntry> entries,
+    const WriteBatchLimits& limits = WriteBatchLimits());
 
 // Sets the forwarding pipeline from the given p4 info.
 absl::Status SetForwardingPipelineConfig(P4RuntimeSession* session,
@@ -171,6 +482,19 @@ absl::Status GetForwardingPipelineConfig(P4RuntimeSession* session,
 // Formats a grpc status about write request into a readable string.
 std::string WriteRequestGrpcStatusToString(const grpc::Status& status);
 
+// Returns the status of each of the `num_updates` updates of a write request
+// from the grpc status of the write. The statuses are taken from the
+// p4::v1::Error details of a failed batch. If the status does not carry exactly
+// one error per update, every update gets the status of the write as a whole.
+std::vector<absl::Status> WriteRequestGrpcStatusToUpdateStatuses(
+    const grpc::Status& status, int num_updates);
+
+// Returns a copy of `write_request` that only contains the updates whose status
+// in `update_statuses` is not OK, e.g. to retry them.
+p4::v1::WriteRequest WriteRequestWithFailedUpdates(
+    const p4::v1::WriteRequest& write_request,
+    absl::Span<const absl::Status> update_statuses);
+
 }  // namespace p4runtime_cpp
 
 #endif  // P4RUNTIME_CPP_P4RUNTIME_SESSION_H_
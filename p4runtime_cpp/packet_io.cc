@@ -0,0 +1,137 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/packet_io.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "glog/logging.h"
+#include "gutil/status.h"
+#include "p4runtime_cpp/bytestring.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::config::v1::ControllerPacketMetadata;
+using ::p4::config::v1::P4Info;
+using ::p4::v1::PacketIn;
+
+namespace {
+
+// The largest metadata id supported by the id to slot table. Metadata ids are
+// numbered from 1 within their header, so this is far from limiting.
+constexpr uint32_t kMaxMetadataId = 4096;
+
+}  // namespace
+
+absl::StatusOr<PacketInDecoder> PacketInDecoder::Create(
+    const P4Info& p4info, absl::string_view header_name) {
+  const ControllerPacketMetadata* header = nullptr;
+  for (const auto& packet_metadata : p4info.controller_packet_metadata()) {
+    if (packet_metadata.preamble().name() == header_name ||
+        packet_metadata.preamble().alias() == header_name) {
+      header = &packet_metadata;
+      break;
+    }
+  }
+  if (header == nullptr) {
+    return gutil::NotFoundErrorBuilder()
+           << "No controller packet metadata named '" << header_name
+           << "' in the P4Info.";
+  }
+  if (header->metadata_size() > DecodedPacketIn::kMaxMetadata) {
+    return gutil::UnimplementedErrorBuilder()
+           << "Controller packet metadata '" << header_name << "' has "
+           << header->metadata_size() << " fields; at most "
+           << DecodedPacketIn::kMaxMetadata << " are supported.";
+  }
+
+  PacketInDecoder decoder;
+  uint32_t max_id = 0;
+  for (const auto& metadata : header->metadata()) {
+    if (metadata.id() > kMaxMetadataId) {
+      return gutil::UnimplementedErrorBuilder()
+             << "Metadata id " << metadata.id() << " of '" << metadata.name()
+             << "' is larger than the supported " << kMaxMetadataId << ".";
+    }
+    max_id = std::max(max_id, metadata.id());
+  }
+  decoder.slot_by_id_.assign(max_id + 1, -1);
+  for (const auto& metadata : header->metadata()) {
+    int8_t& slot = decoder.slot_by_id_[metadata.id()];
+    if (slot != -1) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Duplicate metadata id " << metadata.id() << " in '"
+             << header_name << "'.";
+    }
+    slot = static_cast<int8_t>(decoder.metadata_.size());
+    decoder.metadata_.push_back(metadata);
+  }
+  return decoder;
+}
+
+absl::StatusOr<int> PacketInDecoder::MetadataSlot(
+    absl::string_view name) const {
+  for (int slot = 0; slot < NumMetadata(); ++slot) {
+    if (metadata_[slot].name() == name) return slot;
+  }
+  return gutil::NotFoundErrorBuilder()
+         << "No packet-in metadata named '" << name << "'.";
+}
+
+absl::Status PacketInDecoder::Decode(const PacketIn& packet,
+                                     DecodedPacketIn* decoded) const {
+  decoded->payload_ = packet.payload();
+  decoded->present_ = 0;
+  decoded->values_.fill(0);
+  decoded->bytes_.fill(absl::string_view());
+  for (const auto& metadata : packet.metadata()) {
+    const uint32_t id = metadata.metadata_id();
+    const int slot = id < slot_by_id_.size() ? slot_by_id_[id] : -1;
+    if (slot == -1) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Unknown packet-in metadata id " << id << ".";
+    }
+    if (decoded->HasMetadata(slot)) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Duplicate packet-in metadata id " << id << ".";
+    }
+    decoded->present_ |= uint32_t{1} << slot;
+    decoded->bytes_[slot] = metadata.value();
+
+    // Fields without a bitwidth are translated, i.e. carry strings.
+    const int bitwidth = metadata_[slot].bitwidth();
+    if (bitwidth == 0 || bitwidth > 64) continue;
+    uint64_t value;
+    if (!DecodeBytestring(metadata.value(), bitwidth, &value)) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Value of packet-in metadata '" << metadata_[slot].name()
+             << "' does not fit into " << bitwidth << " bits.";
+    }
+    decoded->values_[slot] = value;
+  }
+  return absl::OkStatus();
+}
+
+absl::Status RegisterPacketInHandler(P4RuntimeSession* session,
+                                     PacketInDecoder decoder,
+                                     PacketInHandler handler,
+                                     int queue_capacity) {
+  // The decoded packet is reused for every packet-in; handlers run on a
+  // single thread.
+  auto decoded = std::make_shared<DecodedPacketIn>();
+  return session->RegisterStreamMessageHandler(
+      p4::v1::StreamMessageResponse::kPacket,
+      [decoder = std::move(decoder), handler = std::move(handler),
+       decoded](const p4::v1::StreamMessageResponse& message) {
+        absl::Status status = decoder.Decode(message.packet(), decoded.get());
+        if (!status.ok()) {
+          LOG_EVERY_N(WARNING, 1000) << "Dropped packet-in: " << status;
+          return;
+        }
+        handler(*decoded);
+      },
+      queue_capacity);
+}
+
+}  // namespace p4runtime_cpp
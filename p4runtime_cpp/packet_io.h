@@ -0,0 +1,103 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_PACKET_IO_H_
+#define P4RUNTIME_CPP_PACKET_IO_H_
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+namespace p4runtime_cpp {
+
+// A decoded packet-in. All views point into the PacketIn it was decoded from
+// and are only valid as long as that message is.
+class DecodedPacketIn {
+ public:
+  // The maximum number of metadata fields of a packet-in header.
+  static constexpr int kMaxMetadata = 32;
+
+  // The payload of the packet.
+  absl::string_view Payload() const { return payload_; }
+
+  // Return true if the packet carries the metadata of the given slot.
+  bool HasMetadata(int slot) const { return (present_ >> slot) & 1; }
+  // Return the value of the metadata of the given slot, or 0 if the packet
+  // does not carry it. Only meaningful for fields of at most 64 bits; use
+  // MetadataBytes for wider or translated (string) fields.
+  uint64_t MetadataValue(int slot) const { return values_[slot]; }
+  // Return the raw bytes of the metadata of the given slot, or an empty view
+  // if the packet does not carry it.
+  absl::string_view MetadataBytes(int slot) const { return bytes_[slot]; }
+
+ private:
+  friend class PacketInDecoder;
+
+  absl::string_view payload_;
+  uint32_t present_ = 0;
+  std::array<uint64_t, kMaxMetadata> values_;
+  std::array<absl::string_view, kMaxMetadata> bytes_;
+};
+
+// Decodes packet-ins using the layout of a packet-in header in the P4Info. The
+// metadata fields of the header are assigned slots in the order they are
+// declared, and a table from metadata id to slot is built once, so that
+// decoding needs no lookup by name and allocates nothing. Immutable, and so
+// safe to share between threads.
+class PacketInDecoder {
+ public:
+  // Compile a decoder for the controller packet metadata with the given name
+  // or alias.
+  static absl::StatusOr<PacketInDecoder> Create(
+      const p4::config::v1::P4Info& p4info,
+      absl::string_view header_name = "packet_in");
+
+  // Return the number of metadata fields, i.e. the number of slots.
+  int NumMetadata() const { return static_cast<int>(metadata_.size()); }
+  // Return the slot of the metadata field with the given name.
+  absl::StatusOr<int> MetadataSlot(absl::string_view name) const;
+  // Return the descriptor of the metadata field of the given slot.
+  const p4::config::v1::ControllerPacketMetadata::Metadata& Metadata(
+      int slot) const {
+    return metadata_[slot];
+  }
+
+  // Decode the packet into `decoded`, which can be reused across packets.
+  // Fails for metadata that is not part of the header, for values that do not
+  // fit the bitwidth of their field, and for duplicate metadata.
+  absl::Status Decode(const p4::v1::PacketIn& packet,
+                      DecodedPacketIn* decoded) const;
+
+ private:
+  PacketInDecoder() = default;
+
+  std::vector<p4::config::v1::ControllerPacketMetadata::Metadata> metadata_;
+  // Slot of every metadata id, or -1 for ids that are not part of the header.
+  std::vector<int8_t> slot_by_id_;
+};
+
+// Invoked for every packet-in, with the decoded packet. The packet is only
+// valid for the duration of the call.
+using PacketInHandler = std::function<void(const DecodedPacketIn& packet)>;
+
+// Register a handler for the packet-ins received by the session, which decodes
+// them with the given decoder. Packet-ins that cannot be decoded are logged and
+// dropped.
+absl::Status RegisterPacketInHandler(P4RuntimeSession* session,
+                                     PacketInDecoder decoder,
+                                     PacketInHandler handler,
+                                     int queue_capacity = 1024);
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_PACKET_IO_H_
@@ -0,0 +1,203 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+// Compares the copying reads ReadTableEntries and ReadCounterEntries with their
+// arena-backed counterparts. The reads go to an in-process P4Runtime server
+// that streams synthesized entries, so no switch is needed:
+//
+//   bazel run -c opt //p4runtime_cpp:read_benchmark -- --num_entries=1000000
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
+#include "grpcpp/grpcpp.h"
+#include "gutil/status.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+ABSL_FLAG(int, num_entries, 100000, "Number of entries per read.");
+ABSL_FLAG(int, entries_per_response, 1000,
+          "Number of entries per read response chunk.");
+ABSL_FLAG(int, iterations, 10, "Number of reads per variant.");
+
+namespace p4runtime_cpp {
+namespace {
+
+using ::p4::v1::Entity;
+using ::p4::v1::ReadRequest;
+using ::p4::v1::ReadResponse;
+
+constexpr int kCounterId = 302000001;
+
+// Answers every read with the same table or counter entries.
+class FakeP4RuntimeService : public p4::v1::P4Runtime::Service {
+ public:
+  FakeP4RuntimeService(std::vector<ReadResponse> table_responses,
+                       std::vector<ReadResponse> counter_responses)
+      : table_responses_(std::move(table_responses)),
+        counter_responses_(std::move(counter_responses)) {}
+
+  grpc::Status Read(grpc::ServerContext* context, const ReadRequest* request,
+                    grpc::ServerWriter<ReadResponse>* writer) override {
+    const bool counters = request->entities_size() > 0 &&
+                          request->entities(0).has_counter_entry();
+    for (const ReadResponse& response :
+         counters ? counter_responses_ : table_responses_) {
+      if (!writer->Write(response)) break;
+    }
+    return grpc::Status::OK;
+  }
+
+ private:
+  const std::vector<ReadResponse> table_responses_;
+  const std::vector<ReadResponse> counter_responses_;
+};
+
+// Splits the entities into response chunks of `entities_per_response`.
+std::vector<ReadResponse> Chunk(std::vector<Entity> entities,
+                                int entities_per_response) {
+  std::vector<ReadResponse> responses;
+  for (size_t i = 0; i < entities.size(); ++i) {
+    if (i % entities_per_response == 0) responses.emplace_back();
+    *responses.back().add_entities() = std::move(entities[i]);
+  }
+  return responses;
+}
+
+// Returns LPM routes with a two-param action, a typical large table.
+std::vector<Entity> TableEntities(int num_entries) {
+  std::vector<Entity> entities(num_entries);
+  for (int i = 0; i < num_entries; ++i) {
+    p4::v1::TableEntry* entry = entities[i].mutable_table_entry();
+    entry->set_table_id(33554433);
+    p4::v1::FieldMatch* vrf = entry->add_match();
+    vrf->set_field_id(1);
+    vrf->mutable_exact()->set_value(std::string(1, static_cast<char>(i % 8)));
+    p4::v1::FieldMatch* dst = entry->add_match();
+    dst->set_field_id(2);
+    dst->mutable_lpm()->set_value(std::string{
+        10, static_cast<char>(i >> 16), static_cast<char>(i >> 8),
+        static_cast<char>(i)});
+    dst->mutable_lpm()->set_prefix_len(32);
+    p4::v1::Action* action = entry->mutable_action()->mutable_action();
+    action->set_action_id(16777217);
+    p4::v1::Action::Param* port = action->add_params();
+    port->set_param_id(1);
+    port->set_value(std::string(1, static_cast<char>(i % 64)));
+    p4::v1::Action::Param* mac = action->add_params();
+    mac->set_param_id(2);
+    mac->set_value(std::string(6, static_cast<char>(i)));
+  }
+  return entities;
+}
+
+std::vector<Entity> CounterEntities(int num_entries) {
+  std::vector<Entity> entities(num_entries);
+  for (int i = 0; i < num_entries; ++i) {
+    p4::v1::CounterEntry* entry = entities[i].mutable_counter_entry();
+    entry->set_counter_id(kCounterId);
+    entry->mutable_index()->set_index(i);
+    entry->mutable_data()->set_byte_count(1500LL * i);
+    entry->mutable_data()->set_packet_count(i);
+  }
+  return entities;
+}
+
+// Runs `read`, which returns the number of entries it read, and prints the
+// fastest of `iterations` runs.
+template <typename ReadFn>
+absl::Status Time(absl::string_view name, int iterations, ReadFn read) {
+  absl::Duration fastest = absl::InfiniteDuration();
+  size_t num_entries = 0;
+  for (int i = 0; i < iterations; ++i) {
+    const absl::Time start = absl::Now();
+    ASSIGN_OR_RETURN(num_entries, read());
+    fastest = std::min(fastest, absl::Now() - start);
+  }
+  std::cout << name << ": " << num_entries << " entries in "
+            << absl::FormatDuration(fastest) << std::endl;
+  return absl::OkStatus();
+}
+
+absl::Status Main() {
+  const int num_entries = absl::GetFlag(FLAGS_num_entries);
+  const int entries_per_response =
+      std::max(absl::GetFlag(FLAGS_entries_per_response), 1);
+  const int iterations = std::max(absl::GetFlag(FLAGS_iterations), 1);
+
+  FakeP4RuntimeService service(
+      Chunk(TableEntities(num_entries), entries_per_response),
+      Chunk(CounterEntities(num_entries), entries_per_response));
+  grpc::ServerBuilder builder;
+  builder.RegisterService(&service);
+  std::unique_ptr<grpc::Server> server = builder.BuildAndStart();
+  if (server == nullptr) {
+    return gutil::InternalErrorBuilder() << "Failed to start the server.";
+  }
+  std::unique_ptr<P4RuntimeSession> session = P4RuntimeSession::Default(
+      p4::v1::P4Runtime::NewStub(
+          server->InProcessChannel(grpc::ChannelArguments())),
+      /*device_id=*/1);
+
+  // The results are kept in StatusOrs so that timing them adds no copies.
+  RETURN_IF_ERROR(Time(
+      "ReadTableEntries", iterations, [&]() -> absl::StatusOr<size_t> {
+        absl::StatusOr<std::vector<p4::v1::TableEntry>> entries =
+            ReadTableEntries(session.get());
+        RETURN_IF_ERROR(entries.status());
+        return entries->size();
+      }));
+  RETURN_IF_ERROR(Time(
+      "ReadTableEntriesOnArena", iterations, [&]() -> absl::StatusOr<size_t> {
+        absl::StatusOr<std::unique_ptr<ArenaReadResult<p4::v1::TableEntry>>>
+            result = ReadTableEntriesOnArena(
+                session.get(), /*include_counter_data=*/false,
+                /*include_meter_config=*/false);
+        RETURN_IF_ERROR(result.status());
+        return (*result)->Entries().size();
+      }));
+  RETURN_IF_ERROR(Time(
+      "ReadCounterEntries", iterations, [&]() -> absl::StatusOr<size_t> {
+        absl::StatusOr<std::vector<p4::v1::CounterEntry>> entries =
+            ReadCounterEntries(session.get(), kCounterId);
+        RETURN_IF_ERROR(entries.status());
+        return entries->size();
+      }));
+  RETURN_IF_ERROR(Time(
+      "ReadCounterEntriesOnArena", iterations,
+      [&]() -> absl::StatusOr<size_t> {
+        absl::StatusOr<std::unique_ptr<ArenaReadResult<p4::v1::CounterEntry>>>
+            result = ReadCounterEntriesOnArena(session.get(), kCounterId);
+        RETURN_IF_ERROR(result.status());
+        return (*result)->Entries().size();
+      }));
+
+  server->Shutdown();
+  return absl::OkStatus();
+}
+
+}  // namespace
+}  // namespace p4runtime_cpp
+
+int main(int argc, char** argv) {
+  absl::SetProgramUsageMessage(
+      "Compares copying and arena-backed reads of table and counter entries.");
+  absl::ParseCommandLine(argc, argv);
+
+  absl::Status status = p4runtime_cpp::Main();
+  if (!status.ok()) std::cerr << status << std::endl;
+  return status.raw_code();
+}
@@ -0,0 +1,166 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/reconcile.h"
+
+#include <utility>
+
+#include "absl/container/flat_hash_set.h"
+#include "glog/logging.h"
+#include "gutil/status.h"
+#include "p4runtime_cpp/table_entry_key.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::Action;
+using ::p4::v1::ActionProfileAction;
+using ::p4::v1::MeterConfig;
+using ::p4::v1::TableAction;
+using ::p4::v1::TableEntry;
+
+namespace {
+
+bool ActionEq(const Action& a, const Action& b) {
+  if (a.action_id() != b.action_id() || a.params_size() != b.params_size()) {
+    return false;
+  }
+  // Actions have few params and the param ids are unique, so a linear search
+  // per param beats sorting.
+  for (const auto& param : a.params()) {
+    bool found = false;
+    for (const auto& other_param : b.params()) {
+      if (param.param_id() != other_param.param_id()) continue;
+      if (param.value() != other_param.value()) return false;
+      found = true;
+      break;
+    }
+    if (!found) return false;
+  }
+  return true;
+}
+
+bool ActionProfileActionEq(const ActionProfileAction& a,
+                           const ActionProfileAction& b) {
+  return ActionEq(a.action(), b.action()) && a.weight() == b.weight() &&
+         a.watch_kind_case() == b.watch_kind_case() &&
+         a.watch() == b.watch() && a.watch_port() == b.watch_port();
+}
+
+bool TableActionEq(const TableAction& a, const TableAction& b) {
+  if (a.type_case() != b.type_case()) return false;
+  switch (a.type_case()) {
+    case TableAction::kAction:
+      return ActionEq(a.action(), b.action());
+    case TableAction::kActionProfileMemberId:
+      return a.action_profile_member_id() == b.action_profile_member_id();
+    case TableAction::kActionProfileGroupId:
+      return a.action_profile_group_id() == b.action_profile_group_id();
+    case TableAction::kActionProfileActionSet: {
+      const auto& a_actions =
+          a.action_profile_action_set().action_profile_actions();
+      const auto& b_actions =
+          b.action_profile_action_set().action_profile_actions();
+      if (a_actions.size() != b_actions.size()) return false;
+      for (int i = 0; i < a_actions.size(); ++i) {
+        if (!ActionProfileActionEq(a_actions[i], b_actions[i])) return false;
+      }
+      return true;
+    }
+    default:
+      return true;
+  }
+}
+
+// A missing meter config is the default meter config, which differs from all
+// explicit ones.
+bool MeterConfigEq(const TableEntry& a, const TableEntry& b) {
+  if (a.has_meter_config() != b.has_meter_config()) return false;
+  const MeterConfig& a_config = a.meter_config();
+  const MeterConfig& b_config = b.meter_config();
+  return a_config.cir() == b_config.cir() &&
+         a_config.cburst() == b_config.cburst() &&
+         a_config.pir() == b_config.pir() &&
+         a_config.pburst() == b_config.pburst();
+}
+
+// Returns true if modifying `installed` is needed to turn it into `desired`,
+// which has the same match key. Compares the fields directly, since reflection
+// is too slow for large tables.
+bool NeedsModify(const TableEntry& installed, const TableEntry& desired) {
+  return installed.metadata() != desired.metadata() ||
+         installed.idle_timeout_ns() != desired.idle_timeout_ns() ||
+         !MeterConfigEq(installed, desired) ||
+         !TableActionEq(installed.action(), desired.action());
+}
+
+// Key functors for sets of pointers to table entries.
+struct TableEntryPtrKeyHash {
+  size_t operator()(const TableEntry* entry) const {
+    return TableEntryKeyHash()(*entry);
+  }
+};
+struct TableEntryPtrKeyEq {
+  bool operator()(const TableEntry* a, const TableEntry* b) const {
+    return TableEntryKeyEq()(*a, *b);
+  }
+};
+
+}  // namespace
+
+absl::StatusOr<TableEntryDelta> ComputeTableEntryDelta(
+    std::vector<TableEntry> installed, absl::Span<const TableEntry> desired) {
+  absl::flat_hash_set<TableEntry, TableEntryKeyHash, TableEntryKeyEq>
+      installed_by_key;
+  installed_by_key.reserve(installed.size());
+  for (auto& entry : installed) installed_by_key.insert(std::move(entry));
+
+  TableEntryDelta delta;
+  absl::flat_hash_set<const TableEntry*, TableEntryPtrKeyHash,
+                      TableEntryPtrKeyEq>
+      desired_keys;
+  desired_keys.reserve(desired.size());
+  for (const auto& entry : desired) {
+    if (!desired_keys.insert(&entry).second) {
+      return gutil::InvalidArgumentErrorBuilder()
+             << "Desired table entries contain a duplicate entry: "
+             << entry.ShortDebugString();
+    }
+    auto installed_entry = installed_by_key.find(entry);
+    if (installed_entry == installed_by_key.end()) {
+      delta.to_insert.push_back(entry);
+      continue;
+    }
+    if (NeedsModify(*installed_entry, entry)) {
+      delta.to_modify.push_back(entry);
+    }
+    // Matched entries are not deleted.
+    installed_by_key.erase(installed_entry);
+  }
+
+  delta.to_delete.reserve(installed_by_key.size());
+  while (!installed_by_key.empty()) {
+    auto node = installed_by_key.extract(installed_by_key.begin());
+    delta.to_delete.push_back(std::move(node.value()));
+  }
+  return delta;
+}
+
+absl::Status Reconcile(P4RuntimeSession* session,
+                       absl::Span<const TableEntry> desired,
+                       const WriteBatchLimits& limits) {
+  ASSIGN_OR_RETURN(std::vector<TableEntry> installed,
+                   ReadTableEntriesWithMeterConfigs(session));
+  ASSIGN_OR_RETURN(TableEntryDelta delta,
+                   ComputeTableEntryDelta(std::move(installed), desired));
+  VLOG(1) << "Reconciling table entries: " << delta.to_delete.size()
+          << " deletes, " << delta.to_modify.size() << " modifications, "
+          << delta.to_insert.size() << " inserts.";
+
+  // Deletes go first to free up table resources for the inserts.
+  RETURN_IF_ERROR(RemoveTableEntries(session, delta.to_delete, limits));
+  RETURN_IF_ERROR(ModifyTableEntries(session, delta.to_modify, limits));
+  RETURN_IF_ERROR(InstallTableEntries(session, delta.to_insert, limits));
+  return absl::OkStatus();
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,47 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_RECONCILE_H_
+#define P4RUNTIME_CPP_RECONCILE_H_
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/types/span.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+
+namespace p4runtime_cpp {
+
+// The table entry changes needed to move a switch from its installed state to a
+// desired state. Entries are identified by their table id, match fields and
+// priority.
+struct TableEntryDelta {
+  // Installed entries that are not desired.
+  std::vector<p4::v1::TableEntry> to_delete;
+  // Desired entries that are installed with a different action, meter config,
+  // idle timeout or metadata.
+  std::vector<p4::v1::TableEntry> to_modify;
+  // Desired entries that are not installed.
+  std::vector<p4::v1::TableEntry> to_insert;
+};
+
+// Computes the minimal set of changes that turns `installed` into `desired`.
+// Entries without a meter config are at the default meter config, so
+// `installed` must be read with meter configs. Returns an error if `desired`
+// contains the same entry twice.
+absl::StatusOr<TableEntryDelta> ComputeTableEntryDelta(
+    std::vector<p4::v1::TableEntry> installed,
+    absl::Span<const p4::v1::TableEntry> desired);
+
+// Reads the installed table entries with their meter configs from the switch,
+// and sends only the deletes, modifications and inserts needed to reach
+// `desired`, in that order, through the batching write path.
+absl::Status Reconcile(P4RuntimeSession* session,
+                       absl::Span<const p4::v1::TableEntry> desired,
+                       const WriteBatchLimits& limits = WriteBatchLimits());
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_RECONCILE_H_
@@ -0,0 +1,69 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_SPSC_QUEUE_H_
+#define P4RUNTIME_CPP_SPSC_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace p4runtime_cpp {
+
+// A bounded, lock-free queue for exactly one producer and one consumer thread.
+// The elements are allocated once, up front, and are recycled: the producer
+// fills a free slot in place and the consumer reads the oldest slot in place,
+// so that nothing is allocated or copied per element.
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t capacity) : slots_(capacity + 1) {}
+
+  // Disable copy semantics.
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer only. Returns the slot to fill next, or nullptr if the queue is
+  // full. The slot still holds the element it was last used for.
+  T* BeginPush() {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    if (Next(tail) == head_.load(std::memory_order_acquire)) return nullptr;
+    return &slots_[tail];
+  }
+
+  // Producer only. Publishes the slot returned by BeginPush to the consumer.
+  void CommitPush() {
+    tail_.store(Next(tail_.load(std::memory_order_relaxed)),
+                std::memory_order_release);
+  }
+
+  // Consumer only. Returns the oldest element, or nullptr if the queue is
+  // empty.
+  T* Front() {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+    return &slots_[head];
+  }
+
+  // Consumer only. Hands the element returned by Front back to the producer.
+  void Pop() {
+    head_.store(Next(head_.load(std::memory_order_relaxed)),
+                std::memory_order_release);
+  }
+
+ private:
+  size_t Next(size_t index) const {
+    return index + 1 == slots_.size() ? 0 : index + 1;
+  }
+
+  // One slot is always left empty to tell a full queue from an empty one.
+  std::vector<T> slots_;
+  // The head is written by the consumer and the tail by the producer; keep
+  // them on separate cache lines.
+  alignas(64) std::atomic<size_t> head_{0};
+  alignas(64) std::atomic<size_t> tail_{0};
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_SPSC_QUEUE_H_
@@ -0,0 +1,206 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/stream_channel.h"
+
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/time/time.h"
+#include "glog/logging.h"
+#include "gutil/status.h"
+#include "p4runtime_cpp/spsc_queue.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::StreamMessageRequest;
+using ::p4::v1::StreamMessageResponse;
+
+// The queue and consumer thread of a single handler.
+class StreamMessageDispatcher::HandlerQueue {
+ public:
+  HandlerQueue(StreamMessageHandler handler, int capacity)
+      : handler_(std::move(handler)), queue_(capacity) {
+    consumer_thread_ = std::thread([this]() { ConsumeLoop(); });
+  }
+
+  ~HandlerQueue() {
+    {
+      absl::MutexLock lock(&mutex_);
+      stopped_ = true;
+      wakeup_.Signal();
+    }
+    consumer_thread_.join();
+  }
+
+  // Reader thread only. Moves the message into the queue, leaving `message`
+  // with the recycled contents of a previously consumed one. Returns false if
+  // the queue is full.
+  bool Push(StreamMessageResponse* message) {
+    StreamMessageResponse* slot = queue_.BeginPush();
+    if (slot == nullptr) return false;
+    slot->Swap(message);
+    queue_.CommitPush();
+    // The consumer only takes the lock to sleep, so the common case of a busy
+    // consumer costs no more than this load.
+    if (consumer_waiting_.load()) {
+      absl::MutexLock lock(&mutex_);
+      wakeup_.Signal();
+    }
+    return true;
+  }
+
+ private:
+  void ConsumeLoop() {
+    while (true) {
+      StreamMessageResponse* message = queue_.Front();
+      if (message != nullptr) {
+        handler_(*message);
+        queue_.Pop();
+        continue;
+      }
+
+      absl::MutexLock lock(&mutex_);
+      if (stopped_) return;
+      consumer_waiting_.store(true);
+      // Re-check after announcing the wait, so that a message pushed in
+      // between is not missed. The timeout bounds the delay should a wakeup
+      // race with the announcement anyway.
+      if (queue_.Front() == nullptr) {
+        wakeup_.WaitWithTimeout(&mutex_, absl::Milliseconds(100));
+      }
+      consumer_waiting_.store(false);
+    }
+  }
+
+  const StreamMessageHandler handler_;
+  SpscQueue<StreamMessageResponse> queue_;
+  std::atomic<bool> consumer_waiting_{false};
+  absl::Mutex mutex_;
+  absl::CondVar wakeup_;
+  bool stopped_ ABSL_GUARDED_BY(mutex_) = false;
+  std::thread consumer_thread_;
+};
+
+StreamMessageDispatcher::StreamMessageDispatcher(
+    grpc::ClientContext* stream_channel_context,
+    grpc::ClientReaderWriter<StreamMessageRequest, StreamMessageResponse>*
+        stream_channel)
+    : stream_channel_context_(stream_channel_context),
+      stream_channel_(stream_channel) {
+  reader_thread_ = std::thread([this]() { ReadLoop(); });
+}
+
+StreamMessageDispatcher::~StreamMessageDispatcher() {
+  // Unblocks the pending read of the reader thread.
+  stream_channel_context_->TryCancel();
+  reader_thread_.join();
+}
+
+absl::Status StreamMessageDispatcher::RegisterHandler(
+    StreamMessageResponse::UpdateCase update_case,
+    StreamMessageHandler handler, int queue_capacity) {
+  if (update_case <= StreamMessageResponse::UPDATE_NOT_SET ||
+      update_case >= kNumUpdateCases) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Invalid stream message update case " << update_case << ".";
+  }
+  if (queue_capacity <= 0) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Queue capacity must be positive, but is " << queue_capacity
+           << ".";
+  }
+  absl::MutexLock lock(&registration_mutex_);
+  if (handler_queues_[update_case].load() != nullptr) {
+    return gutil::AlreadyExistsErrorBuilder()
+           << "A handler for stream message update case " << update_case
+           << " is already registered.";
+  }
+  owned_handler_queues_.push_back(
+      absl::make_unique<HandlerQueue>(std::move(handler), queue_capacity));
+  handler_queues_[update_case].store(owned_handler_queues_.back().get(),
+                                     std::memory_order_release);
+  return absl::OkStatus();
+}
+
+void StreamMessageDispatcher::ReadLoop() {
+  // Every message is read into this buffer and then swapped into a queue slot,
+  // which hands the buffer of an already consumed message back for reuse.
+  StreamMessageResponse message;
+  while (stream_channel_->Read(&message)) {
+    HandlerQueue* queue =
+        handler_queues_[message.update_case()].load(std::memory_order_acquire);
+    if (queue == nullptr || !queue->Push(&message)) {
+      int64_t dropped =
+          dropped_messages_.fetch_add(1, std::memory_order_relaxed) + 1;
+      LOG_EVERY_N(WARNING, 1000)
+          << "Dropped stream message of update case " << message.update_case()
+          << "; " << dropped << " messages dropped in total.";
+    }
+  }
+  stream_closed_.store(true, std::memory_order_release);
+}
+
+StreamMessageWriter::StreamMessageWriter(
+    grpc::ClientReaderWriter<StreamMessageRequest, StreamMessageResponse>*
+        stream_channel,
+    int max_pending_messages)
+    : stream_channel_(stream_channel),
+      max_pending_messages_(max_pending_messages) {
+  writer_thread_ = std::thread([this]() { WriteLoop(); });
+}
+
+StreamMessageWriter::~StreamMessageWriter() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  writer_thread_.join();
+}
+
+absl::Status StreamMessageWriter::Send(StreamMessageRequest message) {
+  absl::MutexLock lock(&mutex_);
+  if (stream_closed_) {
+    return gutil::UnavailableErrorBuilder()
+           << "Unable to send stream message; gRPC stream channel closed.";
+  }
+  if (static_cast<int>(pending_.size()) >= max_pending_messages_) {
+    return gutil::ResourceExhaustedErrorBuilder()
+           << "Unable to send stream message; " << pending_.size()
+           << " messages are already waiting to be written.";
+  }
+  pending_.push_back(std::move(message));
+  return absl::OkStatus();
+}
+
+void StreamMessageWriter::WriteLoop() {
+  std::vector<StreamMessageRequest> burst;
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          this, &StreamMessageWriter::HasPendingMessagesOrShutdown));
+      if (shutdown_) return;
+      burst.swap(pending_);
+    }
+    for (int i = 0; i < static_cast<int>(burst.size()); ++i) {
+      // The last message of the burst goes without the hint, which flushes
+      // everything buffered so far.
+      grpc::WriteOptions options;
+      if (i + 1 < static_cast<int>(burst.size())) options.set_buffer_hint();
+      if (!stream_channel_->Write(burst[i], options)) {
+        LOG(WARNING) << "Stopped writing stream messages; gRPC stream channel "
+                        "closed. Dropped "
+                     << burst.size() - i << " messages.";
+        absl::MutexLock lock(&mutex_);
+        stream_closed_ = true;
+        pending_.clear();
+        return;
+      }
+    }
+    written_messages_.fetch_add(burst.size(), std::memory_order_relaxed);
+    burst.clear();
+  }
+}
+
+}  // namespace p4runtime_cpp
@@ -0,0 +1,149 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_STREAM_CHANNEL_H_
+#define P4RUNTIME_CPP_STREAM_CHANNEL_H_
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "grpcpp/client_context.h"
+#include "p4/v1/p4runtime.grpc.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+
+namespace p4runtime_cpp {
+
+// Invoked for every stream message of a registered kind. The message is owned
+// by the dispatcher and is only valid for the duration of the call.
+using StreamMessageHandler =
+    std::function<void(const p4::v1::StreamMessageResponse& message)>;
+
+// Drains the stream channel of a session on a dedicated reader thread, so that
+// the server never has to hold back stream messages, and dispatches every
+// message by its update case to the handler registered for it. Each handler
+// runs on a thread of its own and is fed through a lock-free single-producer
+// queue of recycled messages. Messages without a handler, and messages for a
+// handler whose queue is full, are dropped.
+class StreamMessageDispatcher {
+ public:
+  // Starts reading from `stream_channel`, which must outlive the dispatcher and
+  // must not be read by anyone else.
+  StreamMessageDispatcher(
+      grpc::ClientContext* stream_channel_context,
+      grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
+                               p4::v1::StreamMessageResponse>* stream_channel);
+  // Cancels the stream channel and stops all threads.
+  ~StreamMessageDispatcher();
+
+  // Disable copy semantics.
+  StreamMessageDispatcher(const StreamMessageDispatcher&) = delete;
+  StreamMessageDispatcher& operator=(const StreamMessageDispatcher&) = delete;
+
+  // Registers the handler for the messages of the given kind, with a queue that
+  // buffers up to `queue_capacity` messages. Only one handler can be registered
+  // per kind.
+  absl::Status RegisterHandler(
+      p4::v1::StreamMessageResponse::UpdateCase update_case,
+      StreamMessageHandler handler, int queue_capacity);
+
+  // Returns the number of messages that have been dropped.
+  int64_t DroppedMessages() const {
+    return dropped_messages_.load(std::memory_order_relaxed);
+  }
+
+  // Returns true once the stream channel has been closed by either side.
+  bool StreamClosed() const {
+    return stream_closed_.load(std::memory_order_acquire);
+  }
+
+ private:
+  class HandlerQueue;
+
+  // The number of update cases of a StreamMessageResponse, including
+  // UPDATE_NOT_SET.
+  static constexpr int kNumUpdateCases = 8;
+
+  // Reads and dispatches messages until the stream channel is closed.
+  void ReadLoop();
+
+  grpc::ClientContext* stream_channel_context_;
+  grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
+                           p4::v1::StreamMessageResponse>* stream_channel_;
+
+  // The handler queues, indexed by update case. Written once on registration
+  // and read by the reader thread without locking.
+  std::array<std::atomic<HandlerQueue*>, kNumUpdateCases> handler_queues_{};
+  // Owns the handler queues.
+  absl::Mutex registration_mutex_;
+  std::vector<std::unique_ptr<HandlerQueue>> owned_handler_queues_
+      ABSL_GUARDED_BY(registration_mutex_);
+
+  std::atomic<int64_t> dropped_messages_{0};
+  std::atomic<bool> stream_closed_{false};
+  std::thread reader_thread_;
+};
+
+// Writes stream messages, e.g. packet-outs, to the stream channel of a session
+// from a single writer thread. Messages may be sent from any number of threads;
+// they are queued and written in the order they were queued. All messages
+// that are queued while a write is in progress are written as one burst, with
+// gRPC buffer hints on all but the last one, so that a burst goes out in few
+// HTTP/2 frames rather than one per message.
+class StreamMessageWriter {
+ public:
+  // Starts writing to `stream_channel`, which must outlive the writer and must
+  // not be written by anyone else.
+  StreamMessageWriter(
+      grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
+                               p4::v1::StreamMessageResponse>* stream_channel,
+      int max_pending_messages);
+  // Stops the writer thread. Messages that have not been written yet are
+  // dropped.
+  ~StreamMessageWriter();
+
+  // Disable copy semantics.
+  StreamMessageWriter(const StreamMessageWriter&) = delete;
+  StreamMessageWriter& operator=(const StreamMessageWriter&) = delete;
+
+  // Queues the message for writing. Returns ResourceExhausted if
+  // `max_pending_messages` are already queued, and Unavailable once the stream
+  // channel is closed. Success does not mean the message has been written.
+  absl::Status Send(p4::v1::StreamMessageRequest message);
+
+  // Returns the number of messages that have been written.
+  int64_t WrittenMessages() const {
+    return written_messages_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  // Writes queued messages until the writer is destroyed or the stream channel
+  // is closed.
+  void WriteLoop();
+  bool HasPendingMessagesOrShutdown() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return shutdown_ || !pending_.empty();
+  }
+
+  grpc::ClientReaderWriter<p4::v1::StreamMessageRequest,
+                           p4::v1::StreamMessageResponse>* stream_channel_;
+  const int max_pending_messages_;
+
+  mutable absl::Mutex mutex_;
+  // Messages in the order they are to be written. The writer thread swaps this
+  // with its own, drained, buffer, so both keep their capacity.
+  std::vector<p4::v1::StreamMessageRequest> pending_ ABSL_GUARDED_BY(mutex_);
+  bool stream_closed_ ABSL_GUARDED_BY(mutex_) = false;
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+
+  std::atomic<int64_t> written_messages_{0};
+  std::thread writer_thread_;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_STREAM_CHANNEL_H_
@@ -0,0 +1,211 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/table_entry_builder.h"
+
+#include <algorithm>
+
+#include "gutil/status.h"
+#include "p4runtime_cpp/p4info_bindings.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::config::v1::MatchField;
+using ::p4::v1::TableEntry;
+
+TableEntryBuilder::TableEntryBuilder(const P4InfoIndex& p4info_index,
+                                     absl::string_view table_name,
+                                     google::protobuf::Arena* arena)
+    : p4info_index_(p4info_index),
+      arena_(arena),
+      entry_(google::protobuf::Arena::CreateMessage<TableEntry>(arena)) {
+  if (!Resolve(p4info_index_.Tables().Get(table_name), &table_)) return;
+  entry_->set_table_id(table_->preamble().id());
+  Resolve(p4info_index_.MatchFields(entry_->table_id()), &match_fields_);
+}
+
+TableEntryBuilder::~TableEntryBuilder() {
+  if (arena_ == nullptr) delete entry_;
+}
+
+const MatchField* TableEntryBuilder::GetMatchField(
+    absl::string_view field, MatchField::MatchType type) {
+  const MatchField* match_field;
+  if (!status_.ok() || !Resolve(match_fields_->Get(field), &match_field)) {
+    return nullptr;
+  }
+  if (match_field->match_type() != type) {
+    status_ = gutil::InvalidArgumentErrorBuilder()
+              << "Match field '" << field << "' is of type "
+              << MatchField::MatchType_Name(match_field->match_type())
+              << ", not " << MatchField::MatchType_Name(type) << ".";
+    return nullptr;
+  }
+  return match_field;
+}
+
+TableEntryBuilder& TableEntryBuilder::Exact(absl::string_view field,
+                                            uint64_t value) {
+  const MatchField* match_field = GetMatchField(field, MatchField::EXACT);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddExactMatch(match_field->id(), match_field->bitwidth(),
+                                 field, value, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Exact(absl::string_view field,
+                                            absl::string_view value) {
+  const MatchField* match_field = GetMatchField(field, MatchField::EXACT);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddExactMatch(match_field->id(), match_field->bitwidth(),
+                                 field, value, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Lpm(absl::string_view field,
+                                          uint64_t value, int prefix_length) {
+  const MatchField* match_field = GetMatchField(field, MatchField::LPM);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddLpmMatch(match_field->id(), match_field->bitwidth(),
+                               field, {value, prefix_length}, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Lpm(absl::string_view field,
+                                          absl::string_view value,
+                                          int prefix_length) {
+  const MatchField* match_field = GetMatchField(field, MatchField::LPM);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddLpmMatch(
+      match_field->id(), match_field->bitwidth(), field,
+      {std::string(value.data(), value.size()), prefix_length}, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Ternary(absl::string_view field,
+                                              uint64_t value, uint64_t mask) {
+  const MatchField* match_field = GetMatchField(field, MatchField::TERNARY);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddTernaryMatch(match_field->id(), match_field->bitwidth(),
+                                   field, {value, mask}, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Ternary(absl::string_view field,
+                                              absl::string_view value,
+                                              absl::string_view mask) {
+  const MatchField* match_field = GetMatchField(field, MatchField::TERNARY);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddTernaryMatch(
+      match_field->id(), match_field->bitwidth(), field,
+      {std::string(value.data(), value.size()),
+       std::string(mask.data(), mask.size())},
+      entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Range(absl::string_view field,
+                                            uint64_t low, uint64_t high) {
+  const MatchField* match_field = GetMatchField(field, MatchField::RANGE);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddRangeMatch(match_field->id(), match_field->bitwidth(),
+                                 field, {low, high}, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Optional(absl::string_view field,
+                                               uint64_t value) {
+  const MatchField* match_field = GetMatchField(field, MatchField::OPTIONAL);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddOptionalMatch(match_field->id(), match_field->bitwidth(),
+                                    field, value, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Optional(absl::string_view field,
+                                               absl::string_view value) {
+  const MatchField* match_field = GetMatchField(field, MatchField::OPTIONAL);
+  if (match_field == nullptr) return *this;
+  Record(bindings::AddOptionalMatch(match_field->id(), match_field->bitwidth(),
+                                    field, value, entry_));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Priority(int32_t priority) {
+  entry_->set_priority(priority);
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Action(absl::string_view action_name) {
+  const p4::config::v1::Action* action;
+  if (!status_.ok() ||
+      !Resolve(p4info_index_.Actions().Get(action_name), &action)) {
+    return *this;
+  }
+  const uint32_t action_id = action->preamble().id();
+  if (std::none_of(table_->action_refs().begin(), table_->action_refs().end(),
+                   [&](const p4::config::v1::ActionRef& action_ref) {
+                     return action_ref.id() == action_id;
+                   })) {
+    status_ = gutil::InvalidArgumentErrorBuilder()
+              << "Action '" << action_name << "' is not an action of table '"
+              << table_->preamble().name() << "'.";
+    return *this;
+  }
+  if (!Resolve(p4info_index_.ActionParams(action_id), &params_)) return *this;
+  entry_->mutable_action()->mutable_action()->set_action_id(action_id);
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Param(absl::string_view param,
+                                            uint64_t value) {
+  if (!status_.ok()) return *this;
+  if (params_ == nullptr) {
+    status_ = gutil::FailedPreconditionErrorBuilder()
+              << "Param '" << param << "' is given before the action.";
+    return *this;
+  }
+  const p4::config::v1::Action::Param* param_info;
+  if (!Resolve(params_->Get(param), &param_info)) return *this;
+  Record(bindings::AddParam(param_info->id(), param_info->bitwidth(), param,
+                            value,
+                            entry_->mutable_action()->mutable_action()));
+  return *this;
+}
+
+TableEntryBuilder& TableEntryBuilder::Param(absl::string_view param,
+                                            absl::string_view value) {
+  if (!status_.ok()) return *this;
+  if (params_ == nullptr) {
+    status_ = gutil::FailedPreconditionErrorBuilder()
+              << "Param '" << param << "' is given before the action.";
+    return *this;
+  }
+  const p4::config::v1::Action::Param* param_info;
+  if (!Resolve(params_->Get(param), &param_info)) return *this;
+  Record(bindings::AddParam(param_info->id(), param_info->bitwidth(), param,
+                            value,
+                            entry_->mutable_action()->mutable_action()));
+  return *this;
+}
+
+absl::StatusOr<TableEntry> TableEntryBuilder::Build() const {
+  RETURN_IF_ERROR(status_);
+  return *entry_;
+}
+
+absl::StatusOr<TableEntry*> TableEntryBuilder::BuildOnArena() {
+  RETURN_IF_ERROR(status_);
+  if (arena_ == nullptr) {
+    return gutil::FailedPreconditionErrorBuilder()
+           << "The builder has no arena to build the entry on.";
+  }
+  if (built_) {
+    return gutil::FailedPreconditionErrorBuilder()
+           << "The entry has already been built.";
+  }
+  built_ = true;
+  return entry_;
+}
+
+}  // namespace p4runtime_cpp
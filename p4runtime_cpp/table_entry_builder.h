@@ -0,0 +1,112 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_TABLE_ENTRY_BUILDER_H_
+#define P4RUNTIME_CPP_TABLE_ENTRY_BUILDER_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "google/protobuf/arena.h"
+#include "p4/config/v1/p4info.pb.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4info_index.h"
+
+namespace p4runtime_cpp {
+
+// Builds a table entry by P4Info names, setting the fields of the proto
+// directly instead of parsing text. Names are resolved through a P4InfoIndex
+// and values are encoded as canonical byte strings of the declared bitwidths.
+// Integer values are given as uint64_t; wider or translated fields take their
+// bytes as a string. The first error, e.g. an unknown name or a value that
+// does not fit, is reported by Build.
+//
+//   ASSIGN_OR_RETURN(p4::v1::TableEntry* entry,
+//                    TableEntryBuilder(index, "ipv4_table", &arena)
+//                        .Exact("vrf_id", "vrf-1")
+//                        .Lpm("ipv4_dst", 0x0a000000, 8)
+//                        .Action("set_nexthop")
+//                        .Param("nexthop_id", 42)
+//                        .BuildOnArena());
+class TableEntryBuilder {
+ public:
+  // Starts an entry of the table with the given name or alias. If `arena` is
+  // given, the entry is allocated on it.
+  TableEntryBuilder(const P4InfoIndex& p4info_index,
+                    absl::string_view table_name,
+                    google::protobuf::Arena* arena = nullptr);
+  ~TableEntryBuilder();
+
+  // Disable copy semantics.
+  TableEntryBuilder(const TableEntryBuilder&) = delete;
+  TableEntryBuilder& operator=(const TableEntryBuilder&) = delete;
+
+  // Match fields. Don't-care matches, i.e. ternary matches with an all-zero
+  // mask and LPM matches with a prefix length of 0, are left out, as required
+  // by P4Runtime. Bits outside of the mask or prefix are cleared.
+  TableEntryBuilder& Exact(absl::string_view field, uint64_t value);
+  TableEntryBuilder& Exact(absl::string_view field, absl::string_view bytes);
+  TableEntryBuilder& Lpm(absl::string_view field, uint64_t value,
+                         int prefix_length);
+  TableEntryBuilder& Lpm(absl::string_view field, absl::string_view bytes,
+                         int prefix_length);
+  TableEntryBuilder& Ternary(absl::string_view field, uint64_t value,
+                             uint64_t mask);
+  TableEntryBuilder& Ternary(absl::string_view field, absl::string_view bytes,
+                             absl::string_view mask);
+  TableEntryBuilder& Range(absl::string_view field, uint64_t low,
+                           uint64_t high);
+  TableEntryBuilder& Optional(absl::string_view field, uint64_t value);
+  TableEntryBuilder& Optional(absl::string_view field,
+                              absl::string_view bytes);
+
+  TableEntryBuilder& Priority(int32_t priority);
+
+  // Sets the action of the entry; its params follow.
+  TableEntryBuilder& Action(absl::string_view action_name);
+  TableEntryBuilder& Param(absl::string_view param, uint64_t value);
+  TableEntryBuilder& Param(absl::string_view param, absl::string_view bytes);
+
+  // Returns a copy of the entry.
+  absl::StatusOr<p4::v1::TableEntry> Build() const;
+  // Returns the entry, which is owned by the arena. Requires an arena.
+  absl::StatusOr<p4::v1::TableEntry*> BuildOnArena();
+
+ private:
+  // Stores the value of `result` in `value`, or records its error.
+  template <typename T>
+  bool Resolve(absl::StatusOr<T> result, T* value) {
+    if (!result.ok()) {
+      status_ = result.status();
+      return false;
+    }
+    *value = *std::move(result);
+    return true;
+  }
+  // Resolves the match field and checks its match type. Returns nullptr after
+  // recording the error otherwise.
+  const p4::config::v1::MatchField* GetMatchField(
+      absl::string_view field, p4::config::v1::MatchField::MatchType type);
+  // Records `status` if it is the first error.
+  void Record(absl::Status status) {
+    if (status_.ok()) status_ = std::move(status);
+  }
+
+  const P4InfoIndex& p4info_index_;
+  google::protobuf::Arena* arena_;
+  p4::v1::TableEntry* entry_;
+  const p4::config::v1::Table* table_ = nullptr;
+  const P4InfoEntityIndex<p4::config::v1::MatchField>* match_fields_ = nullptr;
+  const P4InfoEntityIndex<p4::config::v1::Action::Param>* params_ = nullptr;
+  // The first error.
+  absl::Status status_;
+  bool built_ = false;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_TABLE_ENTRY_BUILDER_H_
@@ -0,0 +1,110 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/table_entry_cache.h"
+
+#include <utility>
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::TableEntry;
+using ::p4::v1::Update;
+using ::p4::v1::WriteRequest;
+
+void TableEntryCache::Apply(const WriteRequest& write_request) {
+  absl::MutexLock lock(&mutex_);
+  for (const auto& update : write_request.updates()) ApplyUpdate(update);
+}
+
+void TableEntryCache::Apply(const WriteRequest& write_request,
+                            absl::Span<const absl::Status> update_statuses) {
+  absl::MutexLock lock(&mutex_);
+  for (int i = 0; i < write_request.updates_size(); ++i) {
+    if (i < static_cast<int>(update_statuses.size()) &&
+        update_statuses[i].ok()) {
+      ApplyUpdate(write_request.updates(i));
+    }
+  }
+}
+
+void TableEntryCache::ApplyUpdate(const Update& update) {
+  if (!update.entity().has_table_entry()) return;
+  const TableEntry& entry = update.entity().table_entry();
+  switch (update.type()) {
+    case Update::INSERT:
+    case Update::MODIFY: {
+      TableEntry cached_entry = entry;
+      // Counter data is not part of the installed state.
+      cached_entry.clear_counter_data();
+      auto& table = tables_[entry.table_id()];
+      table.erase(cached_entry);
+      table.insert(std::move(cached_entry));
+      break;
+    }
+    case Update::DELETE: {
+      auto table = tables_.find(entry.table_id());
+      if (table == tables_.end()) break;
+      table->second.erase(entry);
+      if (table->second.empty()) tables_.erase(table);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void TableEntryCache::Replace(std::vector<TableEntry> entries) {
+  absl::MutexLock lock(&mutex_);
+  tables_.clear();
+  for (auto& entry : entries) {
+    // Counter data and idle times are not part of the installed state.
+    entry.clear_counter_data();
+    entry.clear_time_since_last_hit();
+    auto& table = tables_[entry.table_id()];
+    table.erase(entry);
+    table.insert(std::move(entry));
+  }
+  synced_ = true;
+}
+
+bool TableEntryCache::IsSynced() const {
+  absl::MutexLock lock(&mutex_);
+  return synced_;
+}
+
+std::vector<TableEntry> TableEntryCache::Entries() const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<TableEntry> entries;
+  for (const auto& table : tables_) {
+    entries.insert(entries.end(), table.second.begin(), table.second.end());
+  }
+  return entries;
+}
+
+std::vector<TableEntry> TableEntryCache::Entries(uint32_t table_id) const {
+  absl::MutexLock lock(&mutex_);
+  std::vector<TableEntry> entries;
+  auto table = tables_.find(table_id);
+  if (table == tables_.end()) return entries;
+  entries.assign(table->second.begin(), table->second.end());
+  return entries;
+}
+
+absl::optional<TableEntry> TableEntryCache::Find(
+    const TableEntry& entry) const {
+  absl::MutexLock lock(&mutex_);
+  auto table = tables_.find(entry.table_id());
+  if (table == tables_.end()) return absl::nullopt;
+  auto cached_entry = table->second.find(entry);
+  if (cached_entry == table->second.end()) return absl::nullopt;
+  return *cached_entry;
+}
+
+size_t TableEntryCache::Size() const {
+  absl::MutexLock lock(&mutex_);
+  size_t size = 0;
+  for (const auto& table : tables_) size += table.second.size();
+  return size;
+}
+
+}  // namespace p4runtime_cpp
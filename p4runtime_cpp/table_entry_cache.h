@@ -0,0 +1,77 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_TABLE_ENTRY_CACHE_H_
+#define P4RUNTIME_CPP_TABLE_ENTRY_CACHE_H_
+
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/types/optional.h"
+#include "absl/types/span.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/table_entry_key.h"
+
+namespace p4runtime_cpp {
+
+// A client-side mirror of the table entries installed on a switch, indexed by
+// table id and TableEntryKey. It is kept up to date by applying the writes that
+// have been sent to the switch. Thread-safe.
+class TableEntryCache {
+ public:
+  TableEntryCache() = default;
+
+  // Disable copy semantics.
+  TableEntryCache(const TableEntryCache&) = delete;
+  TableEntryCache& operator=(const TableEntryCache&) = delete;
+
+  // Applies the table entry updates of a successful write request. Updates of
+  // other entities are ignored.
+  void Apply(const p4::v1::WriteRequest& write_request);
+
+  // Applies the table entry updates of a write request whose status in
+  // `update_statuses` is OK.
+  void Apply(const p4::v1::WriteRequest& write_request,
+             absl::Span<const absl::Status> update_statuses);
+
+  // Replaces the contents of the cache with the given entries, e.g. after
+  // reading them from the switch, and marks the cache as synced.
+  void Replace(std::vector<p4::v1::TableEntry> entries);
+
+  // Returns true once the cache has been filled by Replace. Until then, it
+  // holds only the entries written since it was created, which need not be
+  // all entries on the switch.
+  bool IsSynced() const;
+
+  // Returns all cached entries.
+  std::vector<p4::v1::TableEntry> Entries() const;
+
+  // Returns the cached entries of the given table.
+  std::vector<p4::v1::TableEntry> Entries(uint32_t table_id) const;
+
+  // Returns the cached entry with the same key as `entry`.
+  absl::optional<p4::v1::TableEntry> Find(
+      const p4::v1::TableEntry& entry) const;
+
+  // Returns the number of cached entries.
+  size_t Size() const;
+
+ private:
+  void ApplyUpdate(const p4::v1::Update& update)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  mutable absl::Mutex mutex_;
+  // Entries by table id, in sets keyed by the entry keys.
+  absl::flat_hash_map<uint32_t,
+                      absl::flat_hash_set<p4::v1::TableEntry,
+                                          TableEntryKeyHash, TableEntryKeyEq>>
+      tables_ ABSL_GUARDED_BY(mutex_);
+  bool synced_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_TABLE_ENTRY_CACHE_H_
@@ -0,0 +1,120 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/table_entry_key.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <tuple>
+
+#include "absl/hash/hash.h"
+#include "absl/strings/string_view.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::FieldMatch;
+using ::p4::v1::TableEntry;
+
+namespace {
+
+// Returns the hash of a single match field.
+size_t FieldMatchHash(const FieldMatch& field) {
+  using FieldTuple = std::tuple<uint32_t, int, absl::string_view,
+                                absl::string_view, int32_t>;
+  absl::Hash<FieldTuple> hash;
+  switch (field.field_match_type_case()) {
+    case FieldMatch::kExact:
+      return hash(FieldTuple(field.field_id(), FieldMatch::kExact,
+                             field.exact().value(), {}, 0));
+    case FieldMatch::kTernary:
+      return hash(FieldTuple(field.field_id(), FieldMatch::kTernary,
+                             field.ternary().value(), field.ternary().mask(),
+                             0));
+    case FieldMatch::kLpm:
+      return hash(FieldTuple(field.field_id(), FieldMatch::kLpm,
+                             field.lpm().value(), {},
+                             field.lpm().prefix_len()));
+    case FieldMatch::kRange:
+      return hash(FieldTuple(field.field_id(), FieldMatch::kRange,
+                             field.range().low(), field.range().high(), 0));
+    case FieldMatch::kOptional:
+      return hash(FieldTuple(field.field_id(), FieldMatch::kOptional,
+                             field.optional().value(), {}, 0));
+    default:
+      // Architecture-specific match kinds are rare; hash the whole field.
+      return absl::Hash<std::pair<uint32_t, std::string>>()(
+          {field.field_id(), field.SerializeAsString()});
+  }
+}
+
+}  // namespace
+
+bool FieldMatchEq(const FieldMatch& a, const FieldMatch& b) {
+  if (a.field_match_type_case() != b.field_match_type_case()) return false;
+  switch (a.field_match_type_case()) {
+    case FieldMatch::kExact:
+      return a.exact().value() == b.exact().value();
+    case FieldMatch::kTernary:
+      return a.ternary().value() == b.ternary().value() &&
+             a.ternary().mask() == b.ternary().mask();
+    case FieldMatch::kLpm:
+      return a.lpm().value() == b.lpm().value() &&
+             a.lpm().prefix_len() == b.lpm().prefix_len();
+    case FieldMatch::kRange:
+      return a.range().low() == b.range().low() &&
+             a.range().high() == b.range().high();
+    case FieldMatch::kOptional:
+      return a.optional().value() == b.optional().value();
+    default:
+      return a.SerializeAsString() == b.SerializeAsString();
+  }
+}
+
+TableEntryKey::TableEntryKey(const TableEntry& entry) {
+  key_.set_table_id(entry.table_id());
+  key_.set_priority(entry.priority());
+  *key_.mutable_match() = entry.match();
+  // Sorting by field id makes the key canonical. Entries usually have their
+  // match fields in order already, and sorting the pointers avoids copies.
+  auto by_field_id = [](const FieldMatch* a, const FieldMatch* b) {
+    return a->field_id() < b->field_id();
+  };
+  auto* match = key_.mutable_match();
+  if (!std::is_sorted(match->pointer_begin(), match->pointer_end(),
+                      by_field_id)) {
+    std::sort(match->pointer_begin(), match->pointer_end(), by_field_id);
+  }
+}
+
+size_t TableEntryKeyHash::operator()(const TableEntry& entry) const {
+  // Summing the field hashes makes the result independent of the field order.
+  size_t match_hash = 0;
+  for (const auto& field : entry.match()) match_hash += FieldMatchHash(field);
+  return absl::Hash<std::tuple<uint32_t, int32_t, int, size_t>>()(
+      std::make_tuple(entry.table_id(), entry.priority(), entry.match_size(),
+                      match_hash));
+}
+
+bool TableEntryKeyEq::operator()(const TableEntry& a,
+                                 const TableEntry& b) const {
+  if (a.table_id() != b.table_id() || a.priority() != b.priority() ||
+      a.match_size() != b.match_size()) {
+    return false;
+  }
+  // Entries have few match fields and the field ids are unique, so a linear
+  // search per field beats sorting.
+  for (const auto& field : a.match()) {
+    bool found = false;
+    for (const auto& other_field : b.match()) {
+      if (field.field_id() != other_field.field_id()) continue;
+      if (!FieldMatchEq(field, other_field)) return false;
+      found = true;
+      break;
+    }
+    if (!found) return false;
+  }
+  return true;
+}
+
+}  // namespace p4runtime_cpp
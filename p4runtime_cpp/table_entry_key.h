@@ -0,0 +1,66 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_TABLE_ENTRY_KEY_H_
+#define P4RUNTIME_CPP_TABLE_ENTRY_KEY_H_
+
+#include <cstddef>
+#include <utility>
+
+#include "p4/v1/p4runtime.pb.h"
+
+namespace p4runtime_cpp {
+
+// The key of a table entry: its table id, priority and match fields. This is
+// what identifies an entry on the switch. The match fields of the key are
+// sorted by field id, so it does not depend on their order in the entry.
+class TableEntryKey {
+ public:
+  // Extracts the key of the given entry.
+  explicit TableEntryKey(const p4::v1::TableEntry& entry);
+
+  // Returns a table entry that only holds the key fields.
+  const p4::v1::TableEntry& Entry() const { return key_; }
+
+ private:
+  p4::v1::TableEntry key_;
+};
+
+// Compares the matches of two fields with the same field id on their bytes,
+// without reflection. The bytes are expected to be canonical.
+bool FieldMatchEq(const p4::v1::FieldMatch& a, const p4::v1::FieldMatch& b);
+
+// Hashes the key of a table entry. The hash does not depend on the order of the
+// match fields and is computed directly on their bytes, without serializing
+// them. Transparent, so containers keyed by TableEntryKey can be queried with a
+// TableEntry.
+struct TableEntryKeyHash {
+  using is_transparent = void;
+
+  size_t operator()(const p4::v1::TableEntry& entry) const;
+  size_t operator()(const TableEntryKey& key) const {
+    return (*this)(key.Entry());
+  }
+};
+
+// Compares the keys of two table entries, regardless of the order of their
+// match fields.
+struct TableEntryKeyEq {
+  using is_transparent = void;
+
+  bool operator()(const p4::v1::TableEntry& a,
+                  const p4::v1::TableEntry& b) const;
+  bool operator()(const TableEntryKey& a, const TableEntryKey& b) const {
+    return (*this)(a.Entry(), b.Entry());
+  }
+  bool operator()(const TableEntryKey& a, const p4::v1::TableEntry& b) const {
+    return (*this)(a.Entry(), b);
+  }
+  bool operator()(const p4::v1::TableEntry& a, const TableEntryKey& b) const {
+    return (*this)(a, b.Entry());
+  }
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_TABLE_ENTRY_KEY_H_
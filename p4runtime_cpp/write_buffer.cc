@@ -0,0 +1,144 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#include "p4runtime_cpp/write_buffer.h"
+
+#include <utility>
+
+#include "glog/logging.h"
+#include "gutil/status.h"
+
+namespace p4runtime_cpp {
+
+using ::p4::v1::TableEntry;
+using ::p4::v1::Update;
+
+CoalescingWriteBuffer::CoalescingWriteBuffer(P4RuntimeSession* session,
+                                             Options options)
+    : session_(session), options_(std::move(options)) {
+  if (options_.max_delay > absl::ZeroDuration()) {
+    flush_thread_ = std::thread([this]() { FlushLoop(); });
+  }
+}
+
+CoalescingWriteBuffer::~CoalescingWriteBuffer() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  if (flush_thread_.joinable()) flush_thread_.join();
+  absl::Status status = Flush();
+  if (!status.ok()) {
+    LOG(ERROR) << "Failed to flush pending updates: " << status;
+  }
+}
+
+absl::Status CoalescingWriteBuffer::Add(Update::Type type, TableEntry entry) {
+  if (type != Update::INSERT && type != Update::MODIFY &&
+      type != Update::DELETE) {
+    return gutil::InvalidArgumentErrorBuilder()
+           << "Unsupported update type " << Update::Type_Name(type) << ".";
+  }
+  bool full;
+  {
+    absl::MutexLock lock(&mutex_);
+    auto pending = index_.find(entry);
+    if (pending == index_.end()) {
+      if (index_.empty()) oldest_pending_ = absl::Now();
+      index_.emplace(TableEntryKey(entry), pending_.size());
+      Update& update = pending_.emplace_back();
+      update.set_type(type);
+      *update.mutable_entity()->mutable_table_entry() = std::move(entry);
+    } else {
+      Update& update = pending_[pending->second];
+      const Update::Type pending_type = update.type();
+      if (pending_type == Update::INSERT && type == Update::DELETE) {
+        // The entry never has to reach the switch.
+        update.set_type(Update::UNSPECIFIED);
+        update.clear_entity();
+        index_.erase(pending);
+        MaybeCompactPending();
+      } else if (pending_type == Update::INSERT && type == Update::MODIFY) {
+        *update.mutable_entity()->mutable_table_entry() = std::move(entry);
+      } else if (pending_type == Update::MODIFY &&
+                 (type == Update::MODIFY || type == Update::DELETE)) {
+        update.set_type(type);
+        *update.mutable_entity()->mutable_table_entry() = std::move(entry);
+      } else if (pending_type == Update::DELETE && type == Update::INSERT) {
+        update.set_type(Update::MODIFY);
+        *update.mutable_entity()->mutable_table_entry() = std::move(entry);
+      } else {
+        return gutil::InvalidArgumentErrorBuilder()
+               << Update::Type_Name(type) << " cannot follow a pending "
+               << Update::Type_Name(pending_type)
+               << " of the same entry: " << entry.ShortDebugString();
+      }
+    }
+    full = static_cast<int>(index_.size()) >= options_.max_pending_updates;
+  }
+  if (full) return Flush();
+  return absl::OkStatus();
+}
+
+absl::Status CoalescingWriteBuffer::Flush() {
+  absl::Status status = FlushPending();
+  absl::MutexLock lock(&mutex_);
+  absl::Status background_status = std::exchange(flush_error_, {});
+  return status.ok() ? background_status : status;
+}
+
+absl::Status CoalescingWriteBuffer::FlushPending() {
+  absl::MutexLock flush_lock(&flush_mutex_);
+  std::vector<Update> updates;
+  {
+    absl::MutexLock lock(&mutex_);
+    updates.reserve(index_.size());
+    for (auto& update : pending_) {
+      if (update.type() != Update::UNSPECIFIED) {
+        updates.push_back(std::move(update));
+      }
+    }
+    pending_.clear();
+    index_.clear();
+  }
+  return SendBatchedWriteRequests(session_, updates, options_.limits);
+}
+
+void CoalescingWriteBuffer::MaybeCompactPending() {
+  if (pending_.size() - index_.size() <= index_.size()) return;
+  // Keeps the order of the remaining updates.
+  int next = 0;
+  for (Update& update : pending_) {
+    if (update.type() == Update::UNSPECIFIED) continue;
+    index_.find(update.entity().table_entry())->second = next;
+    if (&pending_[next] != &update) pending_[next] = std::move(update);
+    ++next;
+  }
+  pending_.resize(next);
+}
+
+int CoalescingWriteBuffer::PendingUpdates() const {
+  absl::MutexLock lock(&mutex_);
+  return index_.size();
+}
+
+void CoalescingWriteBuffer::FlushLoop() {
+  while (true) {
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(
+          this, &CoalescingWriteBuffer::HasPendingUpdatesOrShutdown));
+      if (shutdown_) return;
+      mutex_.AwaitWithDeadline(absl::Condition(&shutdown_),
+                               oldest_pending_ + options_.max_delay);
+      if (shutdown_) return;
+    }
+    absl::Status status = FlushPending();
+    if (!status.ok()) {
+      absl::MutexLock lock(&mutex_);
+      flush_error_ = status;
+    }
+  }
+}
+
+}  // namespace p4runtime_cpp
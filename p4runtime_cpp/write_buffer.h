@@ -0,0 +1,96 @@
+// Copyright 2021-present Open Networking Foundation
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef P4RUNTIME_CPP_WRITE_BUFFER_H_
+#define P4RUNTIME_CPP_WRITE_BUFFER_H_
+
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "p4/v1/p4runtime.pb.h"
+#include "p4runtime_cpp/p4runtime_session.h"
+#include "p4runtime_cpp/table_entry_key.h"
+
+namespace p4runtime_cpp {
+
+// A write-behind buffer for table entry updates. Updates are held back and
+// coalesced per table entry key until they are flushed to the switch:
+//   INSERT + DELETE -> nothing
+//   INSERT + MODIFY -> INSERT of the modified entry
+//   MODIFY + MODIFY -> the last MODIFY
+//   MODIFY + DELETE -> DELETE
+//   DELETE + INSERT -> MODIFY to the inserted entry
+// The buffer is flushed once enough updates are pending, once the oldest
+// pending update is old enough, or on an explicit Flush. Thread-safe.
+class CoalescingWriteBuffer {
+ public:
+  struct Options {
+    // Flush once this many coalesced updates are pending.
+    int max_pending_updates = 1000;
+    // Flush once the oldest pending update has waited this long. A zero
+    // duration disables time-based flushing.
+    absl::Duration max_delay = absl::Milliseconds(100);
+    // Limits for the write requests sent by a flush.
+    WriteBatchLimits limits;
+  };
+
+  CoalescingWriteBuffer(P4RuntimeSession* session, Options options);
+  // Flushes all pending updates.
+  ~CoalescingWriteBuffer();
+
+  // Disable copy semantics.
+  CoalescingWriteBuffer(const CoalescingWriteBuffer&) = delete;
+  CoalescingWriteBuffer& operator=(const CoalescingWriteBuffer&) = delete;
+
+  // Adds an update of the given entry, flushing if the buffer is full. Returns
+  // an error, without adding the update, for sequences that cannot succeed on
+  // the switch, e.g. two INSERTs of the same entry. Otherwise the update is
+  // added, and errors are those of the flush, see Flush.
+  absl::Status Add(p4::v1::Update::Type type, p4::v1::TableEntry entry);
+
+  // Sends all pending updates to the switch. Returns the failure of this flush
+  // or else of a time-based flush that happened since it was last reported.
+  absl::Status Flush();
+
+  // Returns the number of coalesced updates that are pending.
+  int PendingUpdates() const;
+
+ private:
+  // Sends all pending updates to the switch.
+  absl::Status FlushPending();
+  // Removes the updates that have been coalesced away once they make up more
+  // than half of `pending_`, so that churn cannot grow it without bound.
+  void MaybeCompactPending() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  // Runs the time-based flushing until the buffer is destroyed.
+  void FlushLoop();
+  bool HasPendingUpdatesOrShutdown() const ABSL_SHARED_LOCKS_REQUIRED(mutex_) {
+    return shutdown_ || !index_.empty();
+  }
+
+  P4RuntimeSession* session_;
+  const Options options_;
+
+  // Serializes flushes, so that updates reach the switch in order.
+  absl::Mutex flush_mutex_ ABSL_ACQUIRED_BEFORE(mutex_);
+  mutable absl::Mutex mutex_;
+  // Pending updates in the order their keys were first seen. Updates that have
+  // been coalesced away have type UNSPECIFIED.
+  std::vector<p4::v1::Update> pending_ ABSL_GUARDED_BY(mutex_);
+  // Index of the pending update of every key in `pending_`.
+  absl::flat_hash_map<TableEntryKey, int, TableEntryKeyHash, TableEntryKeyEq>
+      index_ ABSL_GUARDED_BY(mutex_);
+  // When the oldest pending update was added.
+  absl::Time oldest_pending_ ABSL_GUARDED_BY(mutex_);
+  // The failure of the last time-based flush, if not reported yet.
+  absl::Status flush_error_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_) = false;
+  std::thread flush_thread_;
+};
+
+}  // namespace p4runtime_cpp
+
+#endif  // P4RUNTIME_CPP_WRITE_BUFFER_H_